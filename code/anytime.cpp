@@ -0,0 +1,106 @@
+/**
+ * Parallel VLSI Wire Routing via OpenMP
+ * Jack Kasbeer (jkasbeer), Qifang Cai (qcai)
+ */
+
+#include "anytime.h"
+#include "outofcore.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <climits>
+#include <omp.h>
+
+void best_init(best_routes_t *b, int numWires){
+  memset(b, 0, sizeof(best_routes_t));
+  b->numWires = numWires;
+  b->max = b->aggr = INT_MAX;
+  b->paths = (path_t *)malloc(numWires * sizeof(path_t));
+}
+
+void best_free(best_routes_t *b){
+  free(b->paths);
+  free(b->moved);
+  memset(b, 0, sizeof(best_routes_t));
+}
+
+void best_track(best_routes_t *b){
+  b->moved = (char *)calloc(b->numWires, sizeof(char));
+}
+
+/* best_offer *
+ * Runs serially when called from inside a parallel region (a portfolio
+ * exchange), so it does not start a nested team there
+ */
+int best_offer(best_routes_t *b, const wire_t *wires, int max, int aggr){
+  if (!(max < b->max || (max == b->max && aggr < b->aggr))) return -1;
+  const int first = b->max == INT_MAX;
+  char *moved = first ? NULL : b->moved;
+  int copied = 0;
+  #pragma omp parallel for default(shared) reduction(+:copied) schedule(static) \
+    if(!omp_in_parallel())
+  for (int w = 0; w < b->numWires; w++){
+    if (moved != NULL){
+      if (!moved[w]) continue;
+      moved[w] = 0;
+    }
+    if (first || memcmp(&b->paths[w], wires[w].currentPath, sizeof(path_t)) != 0){
+      memcpy(&b->paths[w], wires[w].currentPath, sizeof(path_t));
+      copied++;
+    }
+  }
+  b->max = max;
+  b->aggr = aggr;
+  b->kept++;
+  b->copied += copied;
+  if (first && b->moved != NULL) memset(b->moved, 0, b->numWires);
+  return copied;
+}
+
+void best_restore(const best_routes_t *b, wire_t *wires){
+  if (b->max == INT_MAX) return;
+  #pragma omp parallel for default(shared) schedule(static) if(!omp_in_parallel())
+  for (int w = 0; w < b->numWires; w++)
+    memcpy(wires[w].currentPath, &b->paths[w], sizeof(path_t));
+}
+
+// lay the current routes out (in waves when out of core) and offer them
+static int scoreAndOffer(best_routes_t *b, const anneal_opts_t *opts, cost_t *costs,
+                         wire_t *wires, int numWires){
+  waves_relayout(opts->waves, costs, wires, numWires);
+  updateBoard(costs);
+  return best_offer(b, wires, costs->currentMax, costs->currentAggrTotal);
+}
+
+int runAnytime(cost_t *costs, wire_t *wires, int numWires, const anneal_opts_t *opts,
+               double seconds){
+  const double start = omp_get_wtime();
+  const double stopAt = start + seconds;
+  double longest = 0;
+  int it, bestIter = 0;
+  best_routes_t best;
+  best_init(&best, numWires);
+  best_track(&best);
+  // anneal flags the wires it moves, so offers only compare those
+  anneal_opts_t tracked = *opts;
+  tracked.moved = best.moved;
+  scoreAndOffer(&best, opts, costs, wires, numWires);
+  for (it = 0; it == 0 || stepFits(stopAt, longest); it++){
+    double stepStart = omp_get_wtime();
+    anneal(costs, wires, numWires, &tracked, it, it + 1);
+    int copied = scoreAndOffer(&best, opts, costs, wires, numWires);
+    double step = omp_get_wtime() - stepStart;
+    if (step > longest) longest = step;
+    if (copied >= 0) bestIter = it + 1;
+    if (opts->verbose)
+      printf("Anytime iteration %d: %d/%d, best %d/%d (%d routes copied)\n", it,
+             costs->currentMax, costs->currentAggrTotal, best.max, best.aggr,
+             copied > 0 ? copied : 0);
+  }
+  printf("Anytime: %d iterations in %lf s, best after %d of them; %d improvements "
+         "copied %lld routes\n", it, omp_get_wtime() - start, bestIter, best.kept - 1,
+         best.copied - numWires);
+  best_restore(&best, wires);
+  best_free(&best);
+  return it;
+}
@@ -0,0 +1,54 @@
+/**
+ * Parallel VLSI Wire Routing via OpenMP
+ * Jack Kasbeer (jkasbeer), Qifang Cai (qcai)
+ *
+ * Anytime routing: anneal against a wall-clock deadline and keep the best
+ * route set seen along the way.
+ */
+
+#ifndef __ANYTIME_H__
+#define __ANYTIME_H__
+
+#include "wireroute.h"
+
+/* best_routes_t *
+ * The best scoring route set offered so far.  An offer that scores better
+ * copies only the wires whose route differs from the kept one: with
+ * 'moved' (best_track) just the flagged wires are compared, otherwise all.
+ */
+typedef struct
+{
+  int numWires;
+  int max, aggr;       // score of the kept routes (INT_MAX: none yet)
+  path_t *paths;       // per wire: its kept route
+  int kept;            // offers that improved
+  long long copied;    // routes copied over all of them
+  char *moved;         // per wire: rerouted since the last copy (NULL: untracked)
+} best_routes_t;
+
+void best_init(best_routes_t *b, int numWires);
+void best_free(best_routes_t *b);
+/* Start tracking moved wires; anneal flags them through anneal_opts_t::moved */
+void best_track(best_routes_t *b);
+/* Keep wires' current routes if (max, aggr) beats the kept score; returns
+ * the number of routes copied, or -1 if it does not */
+int best_offer(best_routes_t *b, const wire_t *wires, int max, int aggr);
+/* Put the kept routes back into wires (if any were kept) */
+void best_restore(const best_routes_t *b, wire_t *wires);
+
+/* Does one more step as long as 'longest' fit before 'stopAt'? (omp_get_wtime) */
+static inline int stepFits(double stopAt, double longest){
+  return omp_get_wtime() + longest <= stopAt;
+}
+
+/* runAnytime *
+ * Anneal one iteration at a time for up to 'seconds' of wall-clock time,
+ * stopping early when the slowest iteration so far would not fit in what
+ * is left (at least one always runs).  The routes before the first and
+ * after every iteration are scored; on return 'wires' hold the best of
+ * them (the board is stale).  Returns the number of iterations run.
+ */
+int runAnytime(cost_t *costs, wire_t *wires, int numWires, const anneal_opts_t *opts,
+               double seconds);
+
+#endif /* __ANYTIME_H__ */
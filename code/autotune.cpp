@@ -0,0 +1,133 @@
+/**
+ * Parallel VLSI Wire Routing via OpenMP
+ * Jack Kasbeer (jkasbeer), Qifang Cai (qcai)
+ */
+
+#include "autotune.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <omp.h>
+
+#define LEN_BUCKETS 16 // log2 buckets of Manhattan wire length
+
+static const int chunks[] = {1, 4, 16, 64};
+
+/* tune_signature *
+ * "<dimX>x<dimY>:<wires>:<h0..h15>:<reprs>" where hk is the share of wires
+ * whose length falls in [2^k, 2^(k+1)), in sixteenths, so inputs drawn from
+ * the same distribution share a signature
+ */
+void tune_signature(const wire_t *wires, int numWires, int dimX, int dimY, int reprs,
+                    char *sig){
+  long hist[LEN_BUCKETS];
+  memset(hist, 0, sizeof(hist));
+  #pragma omp parallel for default(shared) reduction(+:hist[:LEN_BUCKETS]) schedule(static)
+  for (int w = 0; w < numWires; w++){
+    const int *b = wires[w].currentPath->bounds;
+    int len = abs(b[2] - b[0]) + abs(b[3] - b[1]);
+    int k = 0;
+    while ((len >>= 1) != 0 && k < LEN_BUCKETS - 1) k++;
+    hist[k]++;
+  }
+  int n = snprintf(sig, TUNE_SIG_LEN, "%dx%d:%d:", dimX, dimY, numWires);
+  for (int k = 0; k < LEN_BUCKETS; k++){
+    long share = numWires ? (hist[k] * 16 + numWires / 2) / numWires : 0;
+    n += snprintf(sig + n, TUNE_SIG_LEN - n, "%lx", share > 15 ? 15 : share);
+  }
+  snprintf(sig + n, TUNE_SIG_LEN - n, ":%d", reprs);
+}
+
+int tune_lookup(const char *cacheFile, const char *sig, tune_config_t *cfg){
+  FILE *f = fopen(cacheFile, "r");
+  char line[256], key[TUNE_SIG_LEN];
+  tune_config_t c;
+  int found = 0;
+  if (f == NULL) return 0;
+  // later lines win, so a re-tune just appends; lines without a
+  // representation predate it and are skipped
+  while (fgets(line, sizeof(line), f) != NULL){
+    if (sscanf(line, "%127s %d %d %d", key, &c.threads, &c.chunk, &c.sparse) != 4)
+      continue;
+    if (strcmp(key, sig) == 0){
+      *cfg = c;
+      found = 1;
+    }
+  }
+  fclose(f);
+  return found;
+}
+
+void tune_store(const char *cacheFile, const char *sig, const tune_config_t *cfg){
+  FILE *f = fopen(cacheFile, "a");
+  if (f == NULL){
+    perror("Error opening tune cache");
+    return;
+  }
+  fprintf(f, "%s %d %d %d\n", sig, cfg->threads, cfg->chunk, cfg->sparse);
+  fclose(f);
+}
+
+void tune_apply(const tune_config_t *cfg){
+  omp_set_num_threads(cfg->threads);
+  omp_set_schedule(omp_sched_dynamic, cfg->chunk);
+}
+
+void tune_calibrate(cost_t *costs, wire_t *wires, int numWires, const anneal_opts_t *opts,
+                    int maxThreads, int iters, int reprs, int huge, tune_config_t *best){
+  using namespace std::chrono;
+  typedef std::chrono::high_resolution_clock Clock;
+  typedef std::chrono::duration<double> dsec;
+  path_t *saved = (path_t *)malloc(numWires * sizeof(path_t));
+  anneal_opts_t quiet = *opts;
+  double bestTime = -1;
+  quiet.verbose = 0;
+  // unseeded runs reseed rand() from the clock per wire, so whole seconds
+  // either all sweep or all go random; seed them so every candidate does
+  // the same work
+  quiet.seeded = 1;
+  for (int w = 0; w < numWires; w++)
+    memcpy(&saved[w], wires[w].currentPath, sizeof(path_t));
+
+  best->sparse = costs->sparse;
+  for (int sparse = 0; sparse < 2; sparse++){
+    if (!(reprs & (sparse ? TUNE_SPARSE : TUNE_DENSE))) continue;
+    const char *name = sparse ? "sparse" : "dense";
+    cost_t trial;
+    region_t trialMem;
+    cost_t *board = costs;
+    if (sparse != costs->sparse){
+      board = &trial;
+      if (allocBoard(board, &trialMem, costs->dimX, costs->dimY, huge, sparse)){
+        printf("Calibrate %s board: out of memory, skipped\n", name);
+        continue;
+      }
+    }
+    // threads: powers of two up to maxThreads, and maxThreads itself
+    for (int t = 1; ; t = (2*t < maxThreads) ? 2*t : maxThreads){
+      for (size_t c = 0; c < sizeof(chunks) / sizeof(chunks[0]); c++){
+        tune_config_t cfg;
+        cfg.threads = t;
+        cfg.chunk = chunks[c];
+        cfg.sparse = sparse;
+        for (int w = 0; w < numWires; w++)
+          memcpy(wires[w].currentPath, &saved[w], sizeof(path_t));
+        tune_apply(&cfg);
+        auto start = Clock::now();
+        anneal(board, wires, numWires, &quiet, 0, iters);
+        double time = duration_cast<dsec>(Clock::now() - start).count();
+        printf("Calibrate %s threads %d chunk %d: %lf\n", name, t, cfg.chunk, time);
+        if (bestTime < 0 || time < bestTime){
+          bestTime = time;
+          *best = cfg;
+        }
+      }
+      if (t == maxThreads) break;
+    }
+    if (board != costs) freeBoard(board, &trialMem);
+  }
+  for (int w = 0; w < numWires; w++)
+    memcpy(wires[w].currentPath, &saved[w], sizeof(path_t));
+  free(saved);
+}
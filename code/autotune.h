@@ -0,0 +1,46 @@
+/**
+ * Parallel VLSI Wire Routing via OpenMP
+ * Jack Kasbeer (jkasbeer), Qifang Cai (qcai)
+ *
+ * Autotuning: time a few annealing iterations of the real input under each
+ * candidate configuration and keep the fastest, cached per input signature.
+ */
+
+#ifndef __AUTOTUNE_H__
+#define __AUTOTUNE_H__
+
+#include <stddef.h>
+#include "wireroute.h"
+
+#define TUNE_SIG_LEN 128
+
+// board representations the tuner may pick (a mask)
+#define TUNE_DENSE  1
+#define TUNE_SPARSE 2
+
+/* tune_config_t *
+ * What the tuner chooses between
+ */
+typedef struct
+{
+  int threads;  // OpenMP threads
+  int chunk;    // chunk of the schedule(runtime) (dynamic) per-wire loops
+  int sparse;   // board representation (allocBoard's 'sparse')
+} tune_config_t;
+
+/* Grid size, wire count, a coarse wire length histogram and the
+ * representations (TUNE_*) the tuner could pick from */
+void tune_signature(const wire_t *wires, int numWires, int dimX, int dimY, int reprs,
+                    char *sig);
+/* Returns 1 and fills cfg if the cache file has an entry for sig */
+int tune_lookup(const char *cacheFile, const char *sig, tune_config_t *cfg);
+void tune_store(const char *cacheFile, const char *sig, const tune_config_t *cfg);
+/* Time 'iters' iterations per candidate (up to maxThreads threads, every
+ * representation in 'reprs').  Candidates of costs' own representation run
+ * on it, the others on a board allocated for them (skipped if that fails);
+ * the wires' routes are restored afterwards */
+void tune_calibrate(cost_t *costs, wire_t *wires, int numWires, const anneal_opts_t *opts,
+                    int maxThreads, int iters, int reprs, int huge, tune_config_t *best);
+void tune_apply(const tune_config_t *cfg);
+
+#endif /* __AUTOTUNE_H__ */
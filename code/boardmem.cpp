@@ -0,0 +1,179 @@
+/**
+ * Parallel VLSI Wire Routing via OpenMP
+ * Jack Kasbeer (jkasbeer), Qifang Cai (qcai)
+ */
+
+#include "boardmem.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <omp.h>
+
+#define MAX_NODES 64      // nodes we keep counts for in the report
+#define REPORT_SAMPLES 4096 // pages sampled per region for the report
+
+// default huge page size from /proc/meminfo, 0 if unknown
+static size_t hugepage_size(void){
+  FILE *f = fopen("/proc/meminfo", "r");
+  char line[256];
+  size_t kb = 0;
+  if (f == NULL) return 0;
+  while (fgets(line, sizeof(line), f) != NULL){
+    if (sscanf(line, "Hugepagesize: %zu kB", &kb) == 1) break;
+  }
+  fclose(f);
+  return kb * 1024;
+}
+
+// directory of the scratch files backing new regions (NULL: memory)
+static const char *backing_dir = NULL;
+
+void region_backing(const char *dir){
+  backing_dir = dir;
+}
+
+// a shared mapping of a fresh, already unlinked file of 'bytes' zeros
+static int file_alloc(region_t *r, size_t bytes, size_t base){
+  char path[1024];
+  snprintf(path, sizeof(path), "%s/wireroute.XXXXXX", backing_dir);
+  int fd = mkstemp(path);
+  if (fd < 0) return -1;
+  unlink(path); // the mapping keeps it alive
+  r->bytes = (bytes + base - 1) / base * base;
+  void *p = MAP_FAILED;
+  if (ftruncate(fd, (off_t)r->bytes) == 0)
+    p = mmap(NULL, r->bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (p == MAP_FAILED) return -1;
+  r->ptr = p;
+  r->page_size = base;
+  r->kind = PAGES_FILE;
+  return 0;
+}
+
+int region_alloc(region_t *r, size_t bytes, int huge){
+  size_t base = (size_t)sysconf(_SC_PAGESIZE);
+  void *p;
+  memset(r, 0, sizeof(region_t));
+  if (bytes == 0) bytes = 1;
+  if (backing_dir != NULL) return file_alloc(r, bytes, base);
+#ifdef MAP_HUGETLB
+  if (huge){
+    size_t hp = hugepage_size();
+    if (hp != 0){
+      size_t len = (bytes + hp - 1) / hp * hp;
+      p = mmap(NULL, len, PROT_READ | PROT_WRITE,
+               MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+      if (p != MAP_FAILED){
+        r->ptr = p;
+        r->bytes = len;
+        r->page_size = hp;
+        r->kind = PAGES_HUGETLB;
+        return 0;
+      }
+    }
+  }
+#endif
+  // No reserved huge pages (or not asked for): regular mapping
+  r->bytes = (bytes + base - 1) / base * base;
+  p = mmap(NULL, r->bytes, PROT_READ | PROT_WRITE,
+           MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (p == MAP_FAILED) return -1;
+  r->ptr = p;
+  r->page_size = base;
+  r->kind = PAGES_BASE;
+#ifdef MADV_HUGEPAGE
+  if (huge && madvise(p, r->bytes, MADV_HUGEPAGE) == 0){
+    size_t hp = hugepage_size();
+    r->kind = PAGES_THP;
+    r->page_size = hp ? hp : base;
+  }
+#endif
+  return 0;
+}
+
+void region_free(region_t *r){
+  if (r->ptr != NULL) munmap(r->ptr, r->bytes);
+  r->ptr = NULL;
+}
+
+void region_prefetch(const region_t *r, size_t off, size_t len){
+  size_t base = (size_t)sysconf(_SC_PAGESIZE);
+  if (r->ptr == NULL || off >= r->bytes) return;
+  if (len > r->bytes - off) len = r->bytes - off;
+  size_t start = off / base * base; // madvise wants a page aligned start
+  madvise((char *)r->ptr + start, len + (off - start), MADV_WILLNEED);
+}
+
+void region_sequential(const region_t *r){
+  if (r->ptr != NULL) madvise(r->ptr, r->bytes, MADV_SEQUENTIAL);
+}
+
+void region_release(const region_t *r, size_t off, size_t len){
+  size_t base = (size_t)sysconf(_SC_PAGESIZE);
+  if (r->kind != PAGES_FILE || r->ptr == NULL || off >= r->bytes) return;
+  if (len > r->bytes - off) len = r->bytes - off;
+  size_t start = off / base * base;
+  // dropping a shared file mapping keeps its dirty pages in the file
+  msync((char *)r->ptr + start, len + (off - start), MS_ASYNC);
+  madvise((char *)r->ptr + start, len + (off - start), MADV_DONTNEED);
+}
+
+void region_report(const char *name, const region_t *r){
+  static const char *kinds[] = {"base", "transparent huge (advised)", "hugetlb", "file"};
+  size_t base = (size_t)sysconf(_SC_PAGESIZE);
+  size_t npages = r->bytes / base;
+  size_t stride = npages > REPORT_SAMPLES ? npages / REPORT_SAMPLES : 1;
+  int count = 0, missing = 0;
+  int perNode[MAX_NODES];
+  void *pages[REPORT_SAMPLES];
+  int status[REPORT_SAMPLES];
+
+  printf("%s: %zu bytes, %s pages of %zu bytes\n", name, r->bytes,
+         kinds[r->kind], r->page_size);
+  for (size_t pg = 0; pg < npages && count < REPORT_SAMPLES; pg += stride)
+    pages[count++] = (char *)r->ptr + pg * base;
+#ifdef SYS_move_pages
+  // move_pages with no target nodes only reports where each page lives
+  if (syscall(SYS_move_pages, 0, (unsigned long)count, pages, NULL, status, 0) != 0){
+    printf("  NUMA placement unavailable\n");
+    return;
+  }
+#else
+  printf("  NUMA placement unavailable\n");
+  return;
+#endif
+  memset(perNode, 0, sizeof(perNode));
+  for (int i = 0; i < count; i++){
+    if (status[i] >= 0 && status[i] < MAX_NODES) perNode[status[i]]++;
+    else missing++;
+  }
+  for (int node = 0; node < MAX_NODES; node++){
+    if (perNode[node] != 0)
+      printf("  node %d: %.1f%% of sampled pages\n", node, 100.0 * perNode[node] / count);
+  }
+  if (missing != 0)
+    printf("  untouched: %.1f%% of sampled pages\n", 100.0 * missing / count);
+}
+
+void pin_threads(void){
+  cpu_set_t allowed;
+  int cpus[CPU_SETSIZE];
+  int ncpu = 0;
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) return;
+  for (int c = 0; c < CPU_SETSIZE; c++)
+    if (CPU_ISSET(c, &allowed)) cpus[ncpu++] = c;
+  if (ncpu == 0) return;
+  #pragma omp parallel default(shared)
+  {
+    cpu_set_t mine;
+    CPU_ZERO(&mine);
+    CPU_SET(cpus[omp_get_thread_num() % ncpu], &mine);
+    sched_setaffinity(0, sizeof(mine), &mine); // 0 == calling thread
+  }
+}
@@ -0,0 +1,54 @@
+/**
+ * Parallel VLSI Wire Routing via OpenMP
+ * Jack Kasbeer (jkasbeer), Qifang Cai (qcai)
+ *
+ * Page-level memory placement for the board and wire arrays: huge page
+ * or file backing, thread pinning and a report of which NUMA node owns the
+ * pages.
+ */
+
+#ifndef __BOARDMEM_H__
+#define __BOARDMEM_H__
+
+#include <stddef.h>
+
+/* Page kinds a region can end up backed by */
+#define PAGES_BASE    0 // regular pages
+#define PAGES_THP     1 // regular mapping, transparent huge pages advised
+#define PAGES_HUGETLB 2 // explicit MAP_HUGETLB mapping
+#define PAGES_FILE    3 // shared mapping of a scratch file (region_backing)
+
+/* region_t *
+ * An anonymous or scratch file mapping (zero filled, untouched until first
+ * write)
+ */
+typedef struct
+{
+  void *ptr;
+  size_t bytes;     // mapped length (rounded up to page_size)
+  size_t page_size; // size of the pages backing the region
+  int kind;         // PAGES_*
+} region_t;
+
+/* Map 'bytes' of memory; huge != 0 asks for MAP_HUGETLB, then THP.
+ * Returns 0 on success, -1 if no mapping could be made */
+int region_alloc(region_t *r, size_t bytes, int huge);
+void region_free(region_t *r);
+/* Back every later region_alloc with an unlinked scratch file in 'dir'
+ * (huge is ignored), so the kernel can page it out to disk; NULL goes
+ * back to anonymous memory */
+void region_backing(const char *dir);
+/* Ask the kernel to start reading [off, off + len) of r in */
+void region_prefetch(const region_t *r, size_t off, size_t len);
+/* Tell the kernel r is mostly walked front to back */
+void region_sequential(const region_t *r);
+/* Start writing [off, off + len) of a file backed r out and drop it from
+ * this mapping, so its pages can be reclaimed (the file keeps the data;
+ * other kinds of region are left alone) */
+void region_release(const region_t *r, size_t off, size_t len);
+/* Print page size and the spread of the region's pages over NUMA nodes */
+void region_report(const char *name, const region_t *r);
+/* Bind OpenMP thread t to cpu t (mod the cpus we may run on) */
+void pin_threads(void);
+
+#endif /* __BOARDMEM_H__ */
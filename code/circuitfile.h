@@ -0,0 +1,25 @@
+/**
+ * Parallel VLSI Wire Routing via OpenMP
+ * Jack Kasbeer (jkasbeer), Qifang Cai (qcai)
+ *
+ * Binary circuit format, an alternative to the text input files:
+ * a circuit_header_t, then numWires records of four int32_t
+ * (x1 y1 x2 y2) in native byte order, written and read as a stream.
+ */
+
+#ifndef __CIRCUITFILE_H__
+#define __CIRCUITFILE_H__
+
+#include <stdint.h>
+
+#define CIRCUIT_MAGIC "WRB1"
+
+typedef struct
+{
+  char magic[4];      // CIRCUIT_MAGIC, no terminator
+  int32_t dimX;
+  int32_t dimY;
+  int32_t numWires;
+} circuit_header_t;
+
+#endif /* __CIRCUITFILE_H__ */
@@ -0,0 +1,81 @@
+/**
+ * Parallel VLSI Wire Routing via OpenMP
+ * Jack Kasbeer (jkasbeer), Qifang Cai (qcai)
+ */
+
+#include "dirtymap.h"
+#include "routekernel.h"
+#include <cstdlib>
+#include <cstring>
+#include <omp.h>
+
+void dirty_init(dirty_map_t *d, const cost_t *costs, int numWires){
+  memset(d, 0, sizeof(dirty_map_t));
+  d->tilesX = costs->tilesX;
+  d->tilesY = costs->tilesY;
+  d->dirty = (char *)malloc((size_t)d->tilesX * d->tilesY);
+  d->sum = (int *)calloc((size_t)(d->tilesX + 1) * (d->tilesY + 1), sizeof(int));
+  d->memo = (route_memo_t *)calloc(numWires, sizeof(route_memo_t));
+}
+
+void dirty_free(dirty_map_t *d){
+  free(d->dirty);
+  free(d->sum);
+  free(d->memo);
+  memset(d, 0, sizeof(dirty_map_t));
+}
+
+// every tile a route covers (racing threads all store 1)
+static inline void markPath(dirty_map_t *d, const path_t *path){
+  walkPath(path, [&](int x, int y){
+    char *t = &d->dirty[(size_t)(y >> BOARD_TILE_SHIFT) * d->tilesX + (x >> BOARD_TILE_SHIFT)];
+    if (!__atomic_load_n(t, __ATOMIC_RELAXED)) __atomic_store_n(t, 1, __ATOMIC_RELAXED);
+  });
+}
+
+int dirty_moved(dirty_map_t *d, const wire_t *wire){
+  if (memcmp(wire->prevPath, wire->currentPath, sizeof(path_t)) == 0) return 0;
+  markPath(d, wire->prevPath);
+  markPath(d, wire->currentPath);
+  return 1;
+}
+
+void dirty_settle(dirty_map_t *d, wire_t *wires, int numWires){
+  const int tilesX = d->tilesX, tilesY = d->tilesY;
+  const size_t stride = (size_t)tilesX + 1;
+  if (!d->primed){
+    memset(d->dirty, 1, (size_t)tilesX * tilesY);
+    d->primed = 1;
+  }
+  // sum[(ty+1)*stride + tx+1] = dirty tiles in [0, tx] x [0, ty]: rows, then columns
+  #pragma omp parallel for default(shared) schedule(static)
+  for (int ty = 0; ty < tilesY; ty++){
+    int run = 0;
+    for (int tx = 0; tx < tilesX; tx++){
+      run += d->dirty[(size_t)ty * tilesX + tx];
+      d->sum[(ty + 1) * stride + tx + 1] = run;
+    }
+  }
+  #pragma omp parallel for default(shared) schedule(static)
+  for (int tx = 1; tx <= tilesX; tx++){
+    for (int ty = 1; ty <= tilesY; ty++)
+      d->sum[ty * stride + tx] += d->sum[(ty - 1) * stride + tx];
+  }
+  #pragma omp parallel for default(shared) schedule(static)
+  for (int w = 0; w < numWires; w++){
+    if (d->memo[w].valid && !dirty_clean(d, wires[w].currentPath))
+      d->memo[w].valid = 0;
+  }
+  memset(d->dirty, 0, (size_t)tilesX * tilesY);
+}
+
+int dirty_clean(const dirty_map_t *d, const path_t *path){
+  const size_t stride = (size_t)d->tilesX + 1;
+  const int *b = path->bounds;
+  int x0 = (b[0] < b[2] ? b[0] : b[2]) >> BOARD_TILE_SHIFT;
+  int x1 = ((b[0] < b[2] ? b[2] : b[0]) >> BOARD_TILE_SHIFT) + 1;
+  int y0 = (b[1] < b[3] ? b[1] : b[3]) >> BOARD_TILE_SHIFT;
+  int y1 = ((b[1] < b[3] ? b[3] : b[1]) >> BOARD_TILE_SHIFT) + 1;
+  return d->sum[y1 * stride + x1] - d->sum[y0 * stride + x1] -
+         d->sum[y1 * stride + x0] + d->sum[y0 * stride + x0] == 0;
+}
@@ -0,0 +1,46 @@
+/**
+ * Parallel VLSI Wire Routing via OpenMP
+ * Jack Kasbeer (jkasbeer), Qifang Cai (qcai)
+ *
+ * Dirty-tile tracking between layouts, so a wire whose bounding box saw no
+ * change can reuse its last sweep instead of searching again.
+ */
+
+#ifndef __DIRTYMAP_H__
+#define __DIRTYMAP_H__
+
+#include "wireroute.h"
+
+/* dirty_map_t *
+ * A board tile is dirty when some wire through it moved between the last
+ * two layouts (the tiles are the board's own BOARD_TILE squares).  The
+ * reroutes mark the tiles as the wires move; the next layout settles them.
+ *
+ * A memo reused this way gives the route a fresh sweep would give as long
+ * as every cell reads the same.  The cell values do, but a cell crossed by
+ * more than WIRE_MAX wires lists only the ones laid out first, and with
+ * more than one thread that order changes from layout to layout, so -memo 1
+ * matches -memo 0 only at one thread or without such cells.
+ */
+typedef struct
+{
+  int tilesX;
+  int tilesY;
+  int primed;          // 0 until the first dirty_settle: everything is dirty
+  char *dirty;         // per tile
+  int *sum;            // (tilesY+1) x (tilesX+1) summed-area table of dirty
+  route_memo_t *memo;  // per wire: its last sweep
+} dirty_map_t;
+
+void dirty_init(dirty_map_t *d, const cost_t *costs, int numWires);
+void dirty_free(dirty_map_t *d);
+/* After a reroute: if the wire's route moved (prevPath to currentPath),
+ * mark the tiles under both and return 1, else 0.  Threads may mark at once */
+int dirty_moved(dirty_map_t *d, const wire_t *wire);
+/* After a layout: drop the memos of wires whose bounding box has a tile
+ * marked since the previous one, then clear the marks */
+void dirty_settle(dirty_map_t *d, wire_t *wires, int numWires);
+/* 1 if no tile of path's bounding box is dirty */
+int dirty_clean(const dirty_map_t *d, const path_t *path);
+
+#endif /* __DIRTYMAP_H__ */
@@ -0,0 +1,254 @@
+/**
+ * Parallel VLSI Wire Routing via OpenMP
+ * Jack Kasbeer (jkasbeer), Qifang Cai (qcai)
+ */
+
+#include "eco.h"
+#include "routekernel.h"
+#include "textfile.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <climits>
+#include <vector>
+#include <algorithm>
+#include <omp.h>
+
+#define MAX_POINTS 4 // start, at most two bends, end
+
+// do the n / 2 points (x y pairs) in pts all lie on the dimX x dimY grid?
+static inline int onGrid(const long long *pts, int n, int dimX, int dimY){
+  for (int i = 0; i + 1 < n; i += 2){
+    if (pts[i] < 0 || pts[i] >= dimX || pts[i+1] < 0 || pts[i+1] >= dimY) return 0;
+  }
+  return 1;
+}
+
+/* routeShape *
+ * Is the route through the n / 2 points one layoutWire lays down as
+ * written?  Straight, an L bending at (e_x,s_y) or (s_x,e_y), or a Z whose
+ * middle segment shares its column or row with the end points' segments.
+ * Returns NULL or what is wrong with it.
+ */
+static const char *routeShape(const long long *pts, int n){
+  for (int p = 0; p + 2 < n; p += 2){
+    if (pts[p] != pts[p+2] && pts[p+1] != pts[p+3])
+      return "segment is not horizontal or vertical";
+  }
+  const long long s_x = pts[0], s_y = pts[1], e_x = pts[n-2], e_y = pts[n-1];
+  switch (n / 2 - 2){
+    case 0:
+      return NULL;
+    case 1:
+      if (pts[3] == s_y ? pts[2] == e_x : pts[2] == s_x && pts[3] == e_y) return NULL;
+      return "bend is not at (end x, start y) or (start x, end y)";
+    default:
+      if (pts[3] == s_y ? pts[4] == pts[2] && pts[5] == e_y
+                        : pts[2] == s_x && pts[5] == pts[3] && pts[4] == e_x) return NULL;
+      return "bends do not form a Z route between the end points";
+  }
+}
+
+// one route line "x y [bx by [bx by]] x y" into a path; returns NULL if it
+// parses, stays on the grid and has a shape layoutWire follows, else why not
+static const char *parseRoute(const char *p, const char *end, int dimX, int dimY,
+                              path_t *path){
+  long long pts[2*MAX_POINTS];
+  int n = 0;
+  long long v;
+  while (n < 2*MAX_POINTS && next_int(&p, end, &v)) pts[n++] = v;
+  if (next_int(&p, end, &v)) return "more than two bends";
+  if (p != end) return "not a number";
+  if (n % 2 != 0) return "end points don't come in pairs";
+  if (n < 4) return "fewer than two points";
+  if (!onGrid(pts, n, dimX, dimY)) return "point outside the grid";
+  const char *why = routeShape(pts, n);
+  if (why != NULL) return why;
+  memset(path, 0, sizeof(path_t));
+  path->numBends = n / 2 - 2;
+  for (int b = 0; b < n - 4; b++) path->bends[b] = (int)pts[2 + b];
+  path->bounds[0] = (int)pts[0];
+  path->bounds[1] = (int)pts[1];
+  path->bounds[2] = (int)pts[n-2];
+  path->bounds[3] = (int)pts[n-1];
+  return NULL;
+}
+
+static inline void endPoints(path_t *path, const long long *b){
+  memset(path, 0, sizeof(path_t));
+  for (int i = 0; i < 4; i++) path->bounds[i] = (int)b[i];
+}
+
+int eco_load(eco_t *eco, const char *routeFile, const char *deltaFile){
+  mapped_file_t route, delta;
+  size_t *lines, *deltaLines = NULL;
+  long numLines, numDelta = 0;
+  long long hdr[2];
+  const char *p;
+  memset(eco, 0, sizeof(eco_t));
+  if (map_file(&route, routeFile)){
+    printf("Unable to open file: %s.\n", routeFile);
+    return -1;
+  }
+  numLines = split_lines(&route, &lines);
+  p = route.data;
+  if (numLines < 2 || !next_int(&p, route.data + lines[1], &hdr[0]) ||
+      !next_int(&p, route.data + lines[1], &hdr[1])){
+    printf("ECO route file: missing dimensions.\n");
+    return -1;
+  }
+  eco->dimX = (int)hdr[0];
+  eco->dimY = (int)hdr[1];
+  p = route.data + lines[1];
+  if (!next_int(&p, route.data + lines[2], &hdr[0]) || numLines != hdr[0] + 2){
+    printf("ECO route file: wire count does not match its lines.\n");
+    return -1;
+  }
+  const int numOld = (int)hdr[0];
+  if (deltaFile != NULL){
+    if (map_file(&delta, deltaFile)){
+      printf("Unable to open file: %s.\n", deltaFile);
+      return -1;
+    }
+    numDelta = split_lines(&delta, &deltaLines);
+  }
+
+  /* Old routes, in parallel */
+  path_t *old = (path_t *)malloc((size_t)numOld * sizeof(path_t));
+  char *state = (char *)calloc(numOld, sizeof(char)); // 1 moved, 2 removed
+  long bad = LONG_MAX;
+  #pragma omp parallel for default(shared) reduction(min:bad) schedule(dynamic, 1024)
+  for (long w = 0; w < numOld; w++){
+    if (parseRoute(route.data + lines[w + 2], route.data + lines[w + 3], eco->dimX,
+                   eco->dimY, &old[w]) != NULL && w < bad)
+      bad = w;
+  }
+  if (bad != LONG_MAX){
+    // parse the first bad one again to say what is wrong with it
+    printf("ECO route file: wire %ld (line %ld) on the %dx%d grid: %s.\n", bad, bad + 3,
+           eco->dimX, eco->dimY,
+           parseRoute(route.data + lines[bad + 2], route.data + lines[bad + 3], eco->dimX,
+                      eco->dimY, &old[bad]));
+    return -1;
+  }
+
+  /* Edits, in order (a later edit of the same wire wins) */
+  std::vector<path_t> added;
+  for (long l = 0; l < numDelta; l++){
+    const char *q = delta.data + deltaLines[l];
+    const char *end = delta.data + deltaLines[l + 1];
+    long long a[5];
+    while (q < end && (*q == ' ' || *q == '\t')) q++;
+    if (q == end || *q == '\n' || *q == '\r' || *q == '#') continue;
+    char op = *q++;
+    int n = 0;
+    while (n < 5 && next_int(&q, end, &a[n])) n++;
+    int ok = (op == '+' && n == 4) || (op == '-' && n == 1) || (op == 'm' && n == 5);
+    if (ok && op != '+' && (a[0] < 0 || a[0] >= numOld || state[a[0]] == 2)) ok = 0;
+    if (!ok){
+      printf("ECO delta file: line %ld is not a valid edit.\n", l + 1);
+      return -1;
+    }
+    if (op != '-' && !onGrid(op == '+' ? a : a + 1, 4, eco->dimX, eco->dimY)){
+      printf("ECO delta file: line %ld has a point outside the %dx%d grid.\n", l + 1,
+             eco->dimX, eco->dimY);
+      return -1;
+    }
+    if (op == '+'){
+      path_t path;
+      endPoints(&path, a);
+      added.push_back(path);
+    }
+    else if (op == '-') state[a[0]] = 2;
+    else{
+      endPoints(&old[a[0]], a + 1);
+      state[a[0]] = 1;
+    }
+  }
+
+  /* Kept wires in route file order, then the added ones */
+  int kept = 0;
+  for (int w = 0; w < numOld; w++){
+    if (state[w] == 2) eco->removed++;
+    else kept++;
+    if (state[w] == 1) eco->moved++;
+  }
+  eco->added = (int)added.size();
+  eco->numWires = kept + eco->added;
+  eco->routes = (path_t *)malloc((size_t)eco->numWires * sizeof(path_t));
+  eco->edited = (char *)calloc(eco->numWires, sizeof(char));
+  int n = 0;
+  for (int w = 0; w < numOld; w++){
+    if (state[w] == 2) continue;
+    eco->routes[n] = old[w];
+    eco->edited[n++] = state[w] == 1;
+  }
+  for (size_t a = 0; a < added.size(); a++){
+    eco->routes[n] = added[a];
+    eco->edited[n++] = 1;
+  }
+
+  free(old);
+  free(state);
+  free(lines);
+  free(deltaLines);
+  unmap_file(&route);
+  if (deltaFile != NULL) unmap_file(&delta);
+  return 0;
+}
+
+void eco_free(eco_t *eco){
+  free(eco->routes);
+  free(eco->edited);
+  memset(eco, 0, sizeof(eco_t));
+}
+
+/* eco_select *
+ * Pass 1: walk the edited routes; a congested cell whose list holds all
+ *         its wires marks them, one whose list is full (more than WIRE_MAX
+ *         wires) goes on the 'full' list instead.
+ * Pass 2: only if there are full cells, every other wire whose bounding
+ *         box meets theirs walks its path looking for one of them.
+ */
+int eco_select(const cost_t *costs, wire_t *wires, int numWires, const char *edited,
+               char *mark, int *out){
+  int count = 0;
+  std::vector<long long> full; // y * dimX + x
+  int loX = INT_MAX, hiX = -1, loY = INT_MAX, hiY = -1;
+  for (int w = 0; w < numWires; w++){
+    if (!edited[w]) continue;
+    mark[w] = 1;
+    walkPath(wires[w].currentPath, [&](int x, int y){
+      const cost_cell_t *c = boardCell(costs, x, y);
+      if (c->val < 2) return;
+      for (int k = 0; k < c->wire; k++) mark[c->list[k]] = 1;
+      if (c->wire >= c->val) return; // the list is every wire through it
+      full.push_back((long long)y * costs->dimX + x);
+      loX = std::min(loX, x);
+      hiX = std::max(hiX, x);
+      loY = std::min(loY, y);
+      hiY = std::max(hiY, y);
+    });
+  }
+  if (!full.empty()){
+    std::sort(full.begin(), full.end());
+    full.erase(std::unique(full.begin(), full.end()), full.end());
+    #pragma omp parallel for default(shared) schedule(dynamic, 256)
+    for (int w = 0; w < numWires; w++){
+      const int *b = wires[w].currentPath->bounds;
+      if (mark[w] || std::max(b[0], b[2]) < loX || std::min(b[0], b[2]) > hiX ||
+          std::max(b[1], b[3]) < loY || std::min(b[1], b[3]) > hiY) continue;
+      int hit = 0;
+      walkPath(wires[w].currentPath, [&](int x, int y){
+        if (!hit && x >= loX && x <= hiX && y >= loY && y <= hiY)
+          hit = std::binary_search(full.begin(), full.end(), (long long)y * costs->dimX + x);
+      });
+      if (hit) mark[w] = 1;
+    }
+  }
+  for (int w = 0; w < numWires; w++){
+    if (mark[w]) out[count++] = w;
+    mark[w] = 0;
+  }
+  return count;
+}
@@ -0,0 +1,50 @@
+/**
+ * Parallel VLSI Wire Routing via OpenMP
+ * Jack Kasbeer (jkasbeer), Qifang Cai (qcai)
+ *
+ * Incremental (ECO) routing: start from a routed design, apply a few wire
+ * edits and reroute only around them.
+ */
+
+#ifndef __ECO_H__
+#define __ECO_H__
+
+#include "wireroute.h"
+
+/* eco_t *
+ * The edited design: routes[w] is wire w's starting route, edited[w] is set
+ * for wires that were added or moved (their route is only the end points)
+ *
+ * Delta file, one edit per line (wire numbers as in the route file,
+ * blank lines and lines starting with '#' are skipped):
+ *   + x1 y1 x2 y2      add a wire (numbered after all kept ones)
+ *   - n                remove wire n
+ *   m n x1 y1 x2 y2    move wire n's end points
+ */
+typedef struct
+{
+  int dimX, dimY;
+  int numWires;
+  path_t *routes;
+  char *edited;
+  int added, removed, moved;
+} eco_t;
+
+/* Load an output_* route file and apply a delta file (NULL: no edits).
+ * Routes must be ones the router writes (straight, L or Z, on the grid).
+ * Prints what is wrong and returns -1 if either does not parse. */
+int eco_load(eco_t *eco, const char *routeFile, const char *deltaFile);
+void eco_free(eco_t *eco);
+
+/* eco_select *
+ * The wires to reroute: every edited wire and every wire it shares a
+ * congested cell (value > 1) with, found through the cells' wire lists
+ * along the edited routes, and for cells with more wires than a list
+ * holds, by walking the routes that pass near them.  'mark' is per wire
+ * scratch (all 0 on entry and exit).  Writes them in wire order to 'out'
+ * and returns how many.
+ */
+int eco_select(const cost_t *costs, wire_t *wires, int numWires, const char *edited,
+               char *mark, int *out);
+
+#endif /* __ECO_H__ */
@@ -0,0 +1,227 @@
+/**
+ * Parallel VLSI Wire Routing via OpenMP
+ * Jack Kasbeer (jkasbeer), Qifang Cai (qcai)
+ *
+ * Synthetic circuit generator for scaling studies.  Every wire draws from
+ * its own random stream (seed, wire index), so the circuit only depends on
+ * the options, never on the thread count.
+ */
+
+#include "options.h"
+#include "circuitfile.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdint.h>
+#include <omp.h>
+
+#define CHUNK_WIRES 65536 // wires formatted per chunk before they are written
+#define LINE_MAX_BYTES 48 // longest "x1 y1 x2 y2\n" line
+
+/* Wire length distributions */
+#define DIST_UNIFORM 0 // both end points uniform on the grid
+#define DIST_EXP     1 // exponential Manhattan length, mean -len
+#define DIST_POW     2 // power law (Rent style), minimum -len, exponent -alpha
+
+typedef struct
+{
+  int dimX, dimY;
+  int dist;
+  double len;       // mean (exp) or minimum (pow) Manhattan length
+  double alpha;     // power law exponent
+  int hotspots;     // number of clusters
+  double hotFrac;   // fraction of wires starting in a cluster
+  double hotRadius; // cluster standard deviation, in cells
+  uint64_t seed;
+} gen_opts_t;
+
+static void show_help(const char *program_path)
+{
+    printf("Usage: %s OPTIONS\n", program_path);
+    printf("\n");
+    printf("OPTIONS:\n");
+    printf("\t-o <output_filename> (required)\n");
+    printf("\t-d <grid_dim> (square grid; or -x <dim_x> -y <dim_y>)\n");
+    printf("\t-w <num_of_wires> (required)\n");
+    printf("\t-dist <uniform|exp|pow> (wire length distribution)\n");
+    printf("\t-len <cells> (exp: mean length, pow: minimum length)\n");
+    printf("\t-alpha <a> (pow: exponent, > 1)\n");
+    printf("\t-hot <num_hotspots>\n");
+    printf("\t-hf <fraction> (share of wires starting in a hotspot)\n");
+    printf("\t-hr <cells> (hotspot radius)\n");
+    printf("\t-seed <seed>\n");
+    printf("\t-format <text|bin>\n");
+    printf("\t-n <num_of_threads>\n");
+}
+
+// splitmix64: tiny, seekable, good enough for circuit layout
+static inline uint64_t nextRand(uint64_t *s){
+  uint64_t z = (*s += 0x9e3779b97f4a7c15ull);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+  return z ^ (z >> 31);
+}
+
+// uniform in [0, 1)
+static inline double nextUnit(uint64_t *s){
+  return (nextRand(s) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static inline int clampInt(long v, int lo, int hi){
+  return v < lo ? lo : (v > hi ? hi : (int)v);
+}
+
+// fold v back into [0, dim) by reflecting off the edges
+static inline int reflect(long v, int dim){
+  long period = 2L * (dim - 1);
+  if (dim <= 1) return 0;
+  v %= period;
+  if (v < 0) v += period;
+  return (int)(v < dim ? v : period - v);
+}
+
+/* genWire *
+ * End points of wire w
+ */
+static void genWire(const gen_opts_t *o, const int *hotX, const int *hotY, long w, int *out){
+  uint64_t s = o->seed ^ ((uint64_t)w * 0xd1b54a32d192ed03ull);
+  int x1, y1, x2, y2;
+  nextRand(&s);
+  // start point: uniform, or gaussian around a hotspot
+  if (o->hotspots > 0 && nextUnit(&s) < o->hotFrac){
+    int h = (int)(nextRand(&s) % o->hotspots);
+    double u1 = nextUnit(&s) + 1e-12, u2 = nextUnit(&s);
+    double r = o->hotRadius * sqrt(-2.0 * log(u1));
+    x1 = clampInt(lround(hotX[h] + r * cos(2 * M_PI * u2)), 0, o->dimX - 1);
+    y1 = clampInt(lround(hotY[h] + r * sin(2 * M_PI * u2)), 0, o->dimY - 1);
+  }
+  else{
+    x1 = (int)(nextRand(&s) % o->dimX);
+    y1 = (int)(nextRand(&s) % o->dimY);
+  }
+  if (o->dist == DIST_UNIFORM){
+    x2 = (int)(nextRand(&s) % o->dimX);
+    y2 = (int)(nextRand(&s) % o->dimY);
+  }
+  else{
+    double len;
+    if (o->dist == DIST_EXP) len = -o->len * log(1.0 - nextUnit(&s));
+    else len = o->len * pow(1.0 - nextUnit(&s), -1.0 / (o->alpha - 1.0));
+    if (len > (double)o->dimX + o->dimY) len = (double)o->dimX + o->dimY;
+    // split the Manhattan length between the axes, random signs
+    double fx = nextUnit(&s);
+    long dx = lround(len * fx), dy = lround(len * (1.0 - fx));
+    if (nextRand(&s) & 1) dx = -dx;
+    if (nextRand(&s) & 1) dy = -dy;
+    x2 = reflect(x1 + dx, o->dimX);
+    y2 = reflect(y1 + dy, o->dimY);
+  }
+  out[0] = x1;
+  out[1] = y1;
+  out[2] = x2;
+  out[3] = y2;
+}
+
+int main(int argc, const char *argv[])
+{
+  using namespace std::chrono;
+  typedef std::chrono::high_resolution_clock Clock;
+  typedef std::chrono::duration<double> dsec;
+  auto start = Clock::now();
+
+  init_options(argc, argv);
+  const char *output_filename = get_option_string("-o", NULL);
+  const char *dist = get_option_string("-dist", "exp");
+  const char *format = get_option_string("-format", "text");
+  int dim = get_option_int("-d", 1024);
+  long num_of_wires = get_option_int("-w", 0);
+  int num_of_threads = get_option_int("-n", omp_get_max_threads());
+  gen_opts_t o;
+  o.dimX = get_option_int("-x", dim);
+  o.dimY = get_option_int("-y", dim);
+  o.len = get_option_float("-len", 0.05f * (o.dimX + o.dimY));
+  o.alpha = get_option_float("-alpha", 2.5f);
+  o.hotspots = get_option_int("-hot", 0);
+  o.hotFrac = get_option_float("-hf", 0.5f);
+  o.hotRadius = get_option_float("-hr", 0.02f * (o.dimX + o.dimY));
+  o.seed = (uint64_t)get_option_int("-seed", 418);
+  if (strcmp(dist, "uniform") == 0) o.dist = DIST_UNIFORM;
+  else if (strcmp(dist, "pow") == 0) o.dist = DIST_POW;
+  else o.dist = DIST_EXP;
+  int binary = strcmp(format, "bin") == 0;
+
+  if (output_filename == NULL || num_of_wires <= 0 || o.dimX <= 0 || o.dimY <= 0 ||
+      (o.dist == DIST_POW && o.alpha <= 1.0)){
+    show_help(argv[0]);
+    return 1;
+  }
+  omp_set_num_threads(num_of_threads);
+
+  // hotspot centres come from their own stream
+  int *hotX = (int *)malloc((o.hotspots + 1) * sizeof(int));
+  int *hotY = (int *)malloc((o.hotspots + 1) * sizeof(int));
+  uint64_t hs = o.seed ^ 0x5bd1e995ull;
+  for (int h = 0; h < o.hotspots; h++){
+    hotX[h] = (int)(nextRand(&hs) % o.dimX);
+    hotY[h] = (int)(nextRand(&hs) % o.dimY);
+  }
+
+  FILE *output = fopen(output_filename, "wb");
+  if (output == NULL){
+    printf("Unable to open file: %s.\n", output_filename);
+    return 1;
+  }
+  if (binary){
+    circuit_header_t hdr;
+    memcpy(hdr.magic, CIRCUIT_MAGIC, sizeof(hdr.magic));
+    hdr.dimX = o.dimX;
+    hdr.dimY = o.dimY;
+    hdr.numWires = (int32_t)num_of_wires;
+    fwrite(&hdr, sizeof(hdr), 1, output);
+  }
+  else{
+    fprintf(output, "%d %d\n%ld\n", o.dimX, o.dimY, num_of_wires);
+  }
+
+  /* Generate and format a chunk in parallel, then append it in order */
+  int32_t *recs = (int32_t *)malloc(4 * sizeof(int32_t) * CHUNK_WIRES);
+  char *text = (char *)malloc((size_t)LINE_MAX_BYTES * CHUNK_WIRES);
+  int *lineLen = (int *)malloc(CHUNK_WIRES * sizeof(int));
+  for (long first = 0; first < num_of_wires; first += CHUNK_WIRES){
+    int n = (int)(num_of_wires - first < CHUNK_WIRES ? num_of_wires - first : CHUNK_WIRES);
+    #pragma omp parallel for default(shared) schedule(static)
+    for (int i = 0; i < n; i++){
+      int pts[4];
+      genWire(&o, hotX, hotY, first + i, pts);
+      memcpy(&recs[4*i], pts, sizeof(pts));
+      if (!binary)
+        lineLen[i] = snprintf(&text[(size_t)i * LINE_MAX_BYTES], LINE_MAX_BYTES, "%d %d %d %d\n",
+                              pts[0], pts[1], pts[2], pts[3]);
+    }
+    if (binary){
+      fwrite(recs, 4 * sizeof(int32_t), n, output);
+    }
+    else{
+      // squeeze the fixed-width slots together before writing
+      size_t used = lineLen[0];
+      for (int i = 1; i < n; i++){
+        memmove(&text[used], &text[(size_t)i * LINE_MAX_BYTES], lineLen[i]);
+        used += lineLen[i];
+      }
+      fwrite(text, 1, used, output);
+    }
+  }
+  fclose(output);
+  printf("Wrote %ld wires on a %dx%d grid to %s (%s) in %lf s.\n", num_of_wires, o.dimX, o.dimY,
+         output_filename, binary ? "bin" : "text",
+         duration_cast<dsec>(Clock::now() - start).count());
+
+  free(recs);
+  free(text);
+  free(lineLen);
+  free(hotX);
+  free(hotY);
+  return 0;
+}
@@ -0,0 +1,70 @@
+/**
+ * Parallel VLSI Wire Routing via OpenMP
+ * Jack Kasbeer (jkasbeer), Qifang Cai (qcai)
+ */
+
+#include "greedy.h"
+#include "outofcore.h"
+#include <cstdlib>
+#include <cstring>
+#include <climits>
+#include <algorithm>
+#include <vector>
+#include <omp.h>
+
+// cheapest route of a wire that is not on the board yet
+static void cheapestRoute(cost_t *costs, wire_t *wire, int wire_n){
+  path_t *path = wire->currentPath;
+  path->numBends = 0;
+  std::memcpy(wire->prevPath, path, sizeof(path_t));
+  if (path->bounds[0] == path->bounds[2] || path->bounds[1] == path->bounds[3])
+    return; // straight
+  value_t best;
+  best.aggr_max = best.m = INT_MAX; // the first L route always wins
+  sweep_ctl_t ctl;
+  std::memset(&ctl, 0, sizeof(ctl));
+  path_t next; // sweepRoutes reads path while it writes the winner
+  std::memcpy(&next, path, sizeof(path_t));
+  sweepRoutes(costs, path, wire_n, &best, &next, &ctl);
+  std::memcpy(path, &next, sizeof(path_t));
+}
+
+void routeGreedy(cost_t *costs, wire_t *wires, int numWires, int batch,
+                 const wave_plan_t *waves){
+  std::vector<std::pair<int, int> > order(numWires); // (-length, wire)
+  const int spans = waves != NULL ? waves->numWaves : 1;
+  if (batch < 1) batch = 1;
+  #pragma omp parallel for default(shared) schedule(static)
+  for (int w = 0; w < numWires; w++){
+    const int *b = wires[w].currentPath->bounds;
+    order[w].first = -(abs(b[2] - b[0]) + abs(b[3] - b[1]));
+    order[w].second = w;
+  }
+
+  int cleared = 0;
+  if (waves == NULL) clearBoard(costs);
+  for (int v = 0; v < spans; v++){
+    // a wave is a run of wire numbers, so sort just its run
+    const int lo = waves != NULL ? waves->first[v] : 0;
+    const int hi = waves != NULL ? waves->first[v + 1] : numWires;
+    std::sort(order.begin() + lo, order.begin() + hi);
+    if (waves != NULL){
+      waves_prefetch(waves, v + 1);
+      waves_clear(waves, costs, v, &cleared);
+    }
+    for (int first = lo; first < hi; first += batch){
+      int last = first + batch < hi ? first + batch : hi;
+      #pragma omp parallel for default(shared) schedule(runtime)
+      for (int k = first; k < last; k++){
+        int w = order[k].second;
+        cheapestRoute(costs, &wires[w], w);
+      } /* implicit barrier */
+      #pragma omp parallel for default(shared) schedule(runtime)
+      for (int k = first; k < last; k++){
+        int w = order[k].second;
+        layoutWire(costs, wires[w].currentPath, w, 1);
+      } /* implicit barrier */
+    }
+    if (waves != NULL) waves_release(waves, v);
+  }
+}
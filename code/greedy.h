@@ -0,0 +1,26 @@
+/**
+ * Parallel VLSI Wire Routing via OpenMP
+ * Jack Kasbeer (jkasbeer), Qifang Cai (qcai)
+ *
+ * Congestion-aware initial routes: route wires longest first, each against
+ * the board the wires before it have built, instead of at random.
+ */
+
+#ifndef __GREEDY_H__
+#define __GREEDY_H__
+
+#include "wireroute.h"
+
+/* routeGreedy *
+ * Clear the board, then route the wires longest first (ties in wire
+ * order), 'batch' wires at a time: every wire of a batch picks its
+ * cheapest L or Z route in parallel against the board as the batches
+ * before it left it, then the batch is laid out.  With 'waves' (not
+ * NULL) it goes wave by wave, longest first inside each wave, reading the
+ * next wave's rows in, clearing a wave's rows just before it routes and
+ * releasing finished ones.  On return the board holds all the routes.
+ */
+void routeGreedy(cost_t *costs, wire_t *wires, int numWires, int batch,
+                 const wave_plan_t *waves);
+
+#endif /* __GREEDY_H__ */
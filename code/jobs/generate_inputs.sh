@@ -0,0 +1,21 @@
+#/usr/bin/env bash
+# generate synthetic inputs for scaling studies with ../gencircuit
+#   strong scaling: one large circuit
+#   weak scaling:   wires (and grid area) grow with the thread count
+
+dims=(4096 8192 16384)     # grid sizes for the strong scaling runs
+wires_per_thread=4096      # weak scaling: wires per thread
+threads=(1 2 4 8 16 32 64) # weak scaling: thread counts
+outdir=../inputs/scaling
+
+mkdir -p $outdir
+for d in ${dims[@]}
+do
+    ../gencircuit -o $outdir/strong_${d}.txt -d $d -w $((d / 4)) -hot 8 -seed 418
+done
+for t in ${threads[@]}
+do
+    # keep wire density constant: area grows with the wire count
+    d=$(python3 -c "import math; print(int(1024 * math.sqrt($t)))")
+    ../gencircuit -o $outdir/weak_${t}.txt -d $d -w $((wires_per_thread * t)) -hot 8 -seed 418
+done
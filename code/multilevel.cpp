@@ -0,0 +1,146 @@
+/**
+ * Parallel VLSI Wire Routing via OpenMP
+ * Jack Kasbeer (jkasbeer), Qifang Cai (qcai)
+ */
+
+#include "multilevel.h"
+#include "outofcore.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <climits>
+#include <omp.h>
+
+static inline void openCorridor(corridor_t *c){
+  c->colLo = c->rowLo = 0;
+  c->colHi = c->rowHi = INT_MAX;
+}
+
+/* refineWire *
+ * Map coarse route cp onto the fine wire: same shape, a bend in the middle
+ * of the coarse bend block, and the blocks the fine bends may move in
+ */
+static void refineWire(wire_t *wire, const path_t *cp, int cells, corridor_t *c){
+  path_t *p = wire->currentPath;
+  const int s_x = p->bounds[0], s_y = p->bounds[1];
+  const int e_x = p->bounds[2], e_y = p->bounds[3];
+  const int cs_x = cp->bounds[0], cs_y = cp->bounds[1];
+  const int ce_x = cp->bounds[2], ce_y = cp->bounds[3];
+  int mid, lo, hi;
+
+  if (cs_x == ce_x || cs_y == ce_y){
+    openCorridor(c);
+    new_rand_path(wire, NULL);
+    return;
+  }
+  c->colLo = c->colHi = c->rowLo = c->rowHi = 0;
+  if (cp->numBends == 1){
+    p->numBends = 1;
+    if (cp->bends[1] == cs_y){ // L horizontal: Z's bending late or early
+      c->colLo = ce_x * cells;
+      c->rowLo = cs_y * cells;
+      p->bends[0] = e_x;
+      p->bends[1] = s_y;
+    }
+    else{                      // L vertical
+      c->colLo = cs_x * cells;
+      c->rowLo = ce_y * cells;
+      p->bends[0] = s_x;
+      p->bends[1] = e_y;
+    }
+    c->colHi = c->colLo + cells;
+    c->rowHi = c->rowLo + cells;
+    return;
+  }
+  p->numBends = 2;
+  if (cp->bends[1] == cs_y){ // Z with a vertical middle: pick the column
+    c->colLo = cp->bends[0] * cells;
+    c->colHi = c->colLo + cells;
+    lo = (s_x < e_x ? s_x : e_x) + 1;
+    hi = (s_x < e_x ? e_x : s_x) - 1;
+    mid = c->colLo + cells / 2;
+    if (mid < lo) mid = lo;
+    if (mid > hi) mid = hi;
+    p->bends[0] = p->bends[2] = mid;
+    p->bends[1] = s_y;
+    p->bends[3] = e_y;
+    if (lo > hi){ // too short for a middle segment: the L
+      p->numBends = 1;
+      p->bends[0] = e_x;
+    }
+  }
+  else{                      // Z with a horizontal middle: pick the row
+    c->rowLo = cp->bends[1] * cells;
+    c->rowHi = c->rowLo + cells;
+    lo = (s_y < e_y ? s_y : e_y) + 1;
+    hi = (s_y < e_y ? e_y : s_y) - 1;
+    mid = c->rowLo + cells / 2;
+    if (mid < lo) mid = lo;
+    if (mid > hi) mid = hi;
+    p->bends[0] = s_x;
+    p->bends[2] = e_x;
+    p->bends[1] = p->bends[3] = mid;
+    if (lo > hi){
+      p->numBends = 1;
+      p->bends[1] = e_y;
+    }
+  }
+}
+
+void routeCoarse(const cost_t *costs, wire_t *wires, int numWires, const anneal_opts_t *opts,
+                 int cells, int iters, corridor_t *corridor){
+  cost_t coarse;
+  region_t mem;
+  anneal_opts_t copts = *opts;
+  const int dimX = (costs->dimX + cells - 1) / cells;
+  const int dimY = (costs->dimY + cells - 1) / cells;
+  path_t *paths = (path_t *)malloc(2 * (size_t)numWires * sizeof(path_t));
+  wire_t *cw = (wire_t *)malloc(numWires * sizeof(wire_t));
+  copts.corridor = NULL;
+  copts.fullIter = iters - 1;
+  copts.focus = NULL;
+  copts.trace = NULL;
+  copts.verbose = 0;
+
+  if (paths == NULL || cw == NULL || allocBoard(&coarse, &mem, dimX, dimY, 0, costs->sparse)){
+    printf("Coarse routing: out of memory, sweeping everything\n");
+    #pragma omp parallel for default(shared) schedule(dynamic)
+    for (int w = 0; w < numWires; w++){
+      openCorridor(&corridor[w]);
+      new_rand_path(&wires[w], NULL);
+    }
+    free(paths);
+    free(cw);
+    return;
+  }
+  #pragma omp parallel for default(shared) schedule(dynamic)
+  for (int w = 0; w < numWires; w++){
+    cw[w].currentPath = &paths[2*w];
+    cw[w].prevPath = &paths[2*w + 1];
+    cw[w].currentPath->numBends = 0;
+    for (int b = 0; b < 4; b++)
+      cw[w].currentPath->bounds[b] = wires[w].currentPath->bounds[b] / cells;
+    new_rand_path(&cw[w], NULL);
+  }
+  // the coarse wires keep the fine ones' row order, so they split into
+  // waves of the coarse board's rows the same way
+  wave_plan_t cwaves;
+  if (opts->waves != NULL){
+    waves_plan(&cwaves, &coarse, &mem, cw, numWires, opts->waves->budget);
+    copts.waves = &cwaves;
+  }
+  anneal(&coarse, cw, numWires, &copts, 0, iters);
+  waves_relayout(copts.waves, &coarse, cw, numWires);
+  updateBoard(&coarse);
+  printf("Coarse routing: %dx%d blocks of %d cells, max %d aggr %d\n", dimX, dimY, cells,
+         coarse.currentMax, coarse.currentAggrTotal);
+
+  #pragma omp parallel for default(shared) schedule(dynamic)
+  for (int w = 0; w < numWires; w++)
+    refineWire(&wires[w], cw[w].currentPath, cells, &corridor[w]);
+
+  if (copts.waves != NULL) waves_free(&cwaves);
+  freeBoard(&coarse, &mem);
+  free(paths);
+  free(cw);
+}
@@ -0,0 +1,24 @@
+/**
+ * Parallel VLSI Wire Routing via OpenMP
+ * Jack Kasbeer (jkasbeer), Qifang Cai (qcai)
+ *
+ * Coarse-to-fine routing: anneal on a board of cells x cells blocks to pick
+ * each wire's shape and bend region, then let the fine sweep look only
+ * inside that corridor.
+ */
+
+#ifndef __MULTILEVEL_H__
+#define __MULTILEVEL_H__
+
+#include "wireroute.h"
+
+/* routeCoarse *
+ * Anneal all wires for 'iters' iterations on a board 'cells' times coarser
+ * than costs (a coarse cell counts every wire crossing its block), then
+ * start each wire from its coarse route and fill in its fine corridor.
+ * Wires that fit within one block row or column sweep everything.
+ */
+void routeCoarse(const cost_t *costs, wire_t *wires, int numWires, const anneal_opts_t *opts,
+                 int cells, int iters, corridor_t *corridor);
+
+#endif /* __MULTILEVEL_H__ */
@@ -0,0 +1,46 @@
+/**
+ * Parallel VLSI Wire Routing via OpenMP
+ * Jack Kasbeer (jkasbeer), Qifang Cai (qcai)
+ */
+
+#include "options.h"
+#include <cstdlib>
+#include <cstring>
+
+static int _argc;
+static const char **_argv;
+
+/////////////////////////////////////
+// COMMAND LINE FUNCTIONS
+////////////////////////////////////
+
+void init_options(int argc, const char *argv[])
+{
+  _argc = argc - 1;
+  _argv = argv + 1;
+}
+
+const char *get_option_string(const char *option_name,
+			      const char *default_value)
+{
+  for (int i = _argc - 2; i >= 0; i -= 2)
+    if (strcmp(_argv[i], option_name) == 0)
+      return _argv[i + 1];
+  return default_value;
+}
+
+int get_option_int(const char *option_name, int default_value)
+{
+  for (int i = _argc - 2; i >= 0; i -= 2)
+    if (strcmp(_argv[i], option_name) == 0)
+      return atoi(_argv[i + 1]);
+  return default_value;
+}
+
+float get_option_float(const char *option_name, float default_value)
+{
+  for (int i = _argc - 2; i >= 0; i -= 2)
+    if (strcmp(_argv[i], option_name) == 0)
+      return (float)atof(_argv[i + 1]);
+  return default_value;
+}
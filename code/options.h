@@ -0,0 +1,19 @@
+/**
+ * Parallel VLSI Wire Routing via OpenMP
+ * Jack Kasbeer (jkasbeer), Qifang Cai (qcai)
+ *
+ * "-name value" command line options, shared by all the tools.
+ */
+
+#ifndef __OPTIONS_H__
+#define __OPTIONS_H__
+
+/* Remember argv (minus the program name) for the getters below */
+void init_options(int argc, const char *argv[]);
+
+/* Command line helper functions */
+const char *get_option_string(const char *option_name, const char *default_value);
+int get_option_int(const char *option_name, int default_value);
+float get_option_float(const char *option_name, float default_value);
+
+#endif /* __OPTIONS_H__ */
@@ -0,0 +1,101 @@
+/**
+ * Parallel VLSI Wire Routing via OpenMP
+ * Jack Kasbeer (jkasbeer), Qifang Cai (qcai)
+ */
+
+#include "outofcore.h"
+#include <cstdlib>
+#include <cstring>
+#include <omp.h>
+
+// tile rows of a wire's bounding box
+static inline void wireRows(const wire_t *wire, int *lo, int *hi){
+  const int *b = wire->currentPath->bounds;
+  *lo = (b[1] < b[3] ? b[1] : b[3]) >> BOARD_TILE_SHIFT;
+  *hi = (b[1] < b[3] ? b[3] : b[1]) >> BOARD_TILE_SHIFT;
+}
+
+int waves_plan(wave_plan_t *p, const cost_t *costs, const region_t *board,
+               wire_t *wires, int numWires, size_t budget){
+  memset(p, 0, sizeof(wave_plan_t));
+  p->board = board;
+  p->rowBytes = (size_t)costs->tilesX * BOARD_TILE_BYTES;
+  p->budget = budget;
+  int maxRows = (int)(budget / p->rowBytes);
+  if (maxRows < 1) maxRows = 1;
+  p->first = (int *)malloc((numWires + 1) * sizeof(int));
+  p->rowLo = (int *)malloc((numWires + 1) * sizeof(int));
+  p->rowHi = (int *)malloc((numWires + 1) * sizeof(int));
+  int w = 0;
+  while (w < numWires){
+    int lo, hi, l, h;
+    const int v = p->numWaves++;
+    wireRows(&wires[w], &lo, &hi);
+    p->first[v] = w++;
+    // wires come by top row, so only the bottom row can grow
+    while (w < numWires){
+      wireRows(&wires[w], &l, &h);
+      if (l < lo || (h > hi ? h : hi) - lo + 1 > maxRows) break;
+      if (h > hi) hi = h;
+      w++;
+    }
+    p->rowLo[v] = lo;
+    p->rowHi[v] = hi;
+  }
+  p->first[p->numWaves] = numWires;
+  region_sequential(board);
+  return p->numWaves;
+}
+
+void waves_free(wave_plan_t *p){
+  free(p->first);
+  free(p->rowLo);
+  free(p->rowHi);
+  memset(p, 0, sizeof(wave_plan_t));
+}
+
+void waves_prefetch(const wave_plan_t *p, int v){
+  if (v >= p->numWaves) return;
+  region_prefetch(p->board, (size_t)p->rowLo[v] * p->rowBytes,
+                  (size_t)(p->rowHi[v] - p->rowLo[v] + 1) * p->rowBytes);
+}
+
+void waves_release(const wave_plan_t *p, int v){
+  // waves come by top row, so no later one reaches above rowLo[v + 1]
+  size_t off = (size_t)p->rowLo[v] * p->rowBytes;
+  size_t end = v + 1 < p->numWaves ? (size_t)p->rowLo[v + 1] * p->rowBytes : p->board->bytes;
+  if (end > off) region_release(p->board, off, end - off);
+}
+
+void waves_clear(const wave_plan_t *p, cost_t *costs, int v, int *cleared){
+  const int tilesX = costs->tilesX;
+  const int lo = p->rowLo[v] > *cleared ? p->rowLo[v] : *cleared;
+  #pragma omp parallel for default(shared) schedule(static)
+  for (int ty = lo; ty <= p->rowHi[v]; ty++){
+    for (int tx = 0; tx < tilesX; tx++)
+      clearTile(costs->tiles[(size_t)ty * tilesX + tx]);
+  }
+  if (p->rowHi[v] + 1 > *cleared) *cleared = p->rowHi[v] + 1;
+}
+
+void waves_layout(const wave_plan_t *p, cost_t *costs, wire_t *wires){
+  int cleared = 0;
+  for (int v = 0; v < p->numWaves; v++){
+    waves_prefetch(p, v + 1);
+    waves_clear(p, costs, v, &cleared);
+    #pragma omp parallel for default(shared) schedule(runtime)
+    for (int w = p->first[v]; w < p->first[v + 1]; w++)
+      layoutWire(costs, wires[w].currentPath, w, 1);
+    /* implicit barrier */
+    waves_release(p, v);
+  }
+}
+
+void waves_relayout(const wave_plan_t *p, cost_t *costs, wire_t *wires, int numWires){
+  if (p != NULL){
+    waves_layout(p, costs, wires);
+    return;
+  }
+  clearBoard(costs);
+  layoutBoard(costs, wires, numWires);
+}
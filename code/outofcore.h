@@ -0,0 +1,34 @@
+/**
+ * Parallel VLSI Wire Routing via OpenMP
+ * Jack Kasbeer (jkasbeer), Qifang Cai (qcai)
+ *
+ * Out-of-core routing: with the board and wires backed by scratch files,
+ * work through the wires in waves whose board rows fit in memory, reading
+ * the next wave's rows in while the current one runs.
+ */
+
+#ifndef __OUTOFCORE_H__
+#define __OUTOFCORE_H__
+
+#include "wireroute.h"
+
+/* Plan waves of at most 'budget' bytes of board (a taller wire gets a wave
+ * to itself) and advise the board's region as read in order.  Returns the
+ * number of waves. */
+int waves_plan(wave_plan_t *p, const cost_t *costs, const region_t *board,
+               wire_t *wires, int numWires, size_t budget);
+void waves_free(wave_plan_t *p);
+/* Start reading wave v's rows in (nothing if there is no wave v) */
+void waves_prefetch(const wave_plan_t *p, int v);
+/* Wave v is done: release the rows no later wave of the pass touches */
+void waves_release(const wave_plan_t *p, int v);
+/* Before wave v of a pass that starts with *cleared = 0: clear its rows no
+ * earlier wave reached.  Rows no wave reaches never hold a route. */
+void waves_clear(const wave_plan_t *p, cost_t *costs, int v, int *cleared);
+/* clearBoard + layoutBoard, wave by wave, so only a wave's rows are in
+ * memory when they are cleared */
+void waves_layout(const wave_plan_t *p, cost_t *costs, wire_t *wires);
+/* waves_layout (clearBoard + layoutBoard if p is NULL) */
+void waves_relayout(const wave_plan_t *p, cost_t *costs, wire_t *wires, int numWires);
+
+#endif /* __OUTOFCORE_H__ */
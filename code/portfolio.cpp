@@ -0,0 +1,164 @@
+/**
+ * Parallel VLSI Wire Routing via OpenMP
+ * Jack Kasbeer (jkasbeer), Qifang Cai (qcai)
+ */
+
+#include "portfolio.h"
+#include "anytime.h"
+#include "outofcore.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <omp.h>
+
+/* chain_t *
+ * One annealing chain; chain 0 borrows the caller's board and wires
+ */
+typedef struct
+{
+  cost_t own;          // board of chains 1..k-1
+  cost_t *costs;
+  wire_t *wires;
+  region_t boardMem, wireMem, pathMem;
+  anneal_opts_t opts;
+  int failed;          // could not allocate, sits out
+  int max, aggr;       // score after the last round
+} chain_t;
+
+// lower max wins, then lower aggregate
+static inline int betterScore(int max, int aggr, int bestMax, int bestAggr){
+  return max < bestMax || (max == bestMax && aggr < bestAggr);
+}
+
+/* newChain *
+ * Allocate (on the chain's own thread group) and randomly route a copy of
+ * the caller's wires.  Returns 0 on success.
+ */
+static int newChain(chain_t *c, const cost_t *costs, const wire_t *wires, int numWires,
+                    int huge){
+  path_t *paths;
+  if (allocBoard(&c->own, &c->boardMem, costs->dimX, costs->dimY, huge, costs->sparse))
+    return -1;
+  if (region_alloc(&c->wireMem, numWires * sizeof(wire_t), huge) ||
+      region_alloc(&c->pathMem, 2 * numWires * sizeof(path_t), huge)){
+    freeBoard(&c->own, &c->boardMem);
+    region_free(&c->wireMem);
+    region_free(&c->pathMem);
+    return -1;
+  }
+  c->costs = &c->own;
+  c->wires = (wire_t *)c->wireMem.ptr;
+  paths = (path_t *)c->pathMem.ptr;
+  #pragma omp parallel for default(shared) schedule(static)
+  for (int w = 0; w < numWires; w++){
+    unsigned int ws = c->opts.seed + (unsigned int)w;
+    c->wires[w].currentPath = &paths[2*w];
+    c->wires[w].prevPath = &paths[2*w + 1];
+    memcpy(c->wires[w].currentPath, wires[w].currentPath, sizeof(path_t));
+    new_rand_path(&c->wires[w], &ws);
+  }
+  return 0;
+}
+
+/* exchangeRound *
+ * Keep the best routes seen so far, then let neighbouring chains (ordered
+ * by SA_prob, coldest first) swap routes when the hotter one scores better,
+ * so good solutions drift towards the greedy chains
+ */
+static void exchangeRound(chain_t *chain, int chains, int numWires, int iter,
+                          best_routes_t *best, path_t *tmp){
+  int k, w;
+  printf("Portfolio iteration %d:", iter);
+  for (k = 0; k < chains; k++){
+    if (chain[k].failed) continue;
+    printf(" [%d] %d/%d", k, chain[k].max, chain[k].aggr);
+    best_offer(best, chain[k].wires, chain[k].max, chain[k].aggr);
+  }
+  printf(", best %d/%d\n", best->max, best->aggr);
+  for (k = 0; k + 1 < chains; k++){
+    chain_t *cold = &chain[k], *hot = &chain[k + 1];
+    if (cold->failed || hot->failed) continue;
+    if (!betterScore(hot->max, hot->aggr, cold->max, cold->aggr)) continue;
+    for (w = 0; w < numWires; w++){
+      memcpy(tmp, cold->wires[w].currentPath, sizeof(path_t));
+      memcpy(cold->wires[w].currentPath, hot->wires[w].currentPath, sizeof(path_t));
+      memcpy(hot->wires[w].currentPath, tmp, sizeof(path_t));
+    }
+    int m = cold->max, a = cold->aggr;
+    cold->max = hot->max;
+    cold->aggr = hot->aggr;
+    hot->max = m;
+    hot->aggr = a;
+  }
+}
+
+void runPortfolio(cost_t *costs, wire_t *wires, int numWires, const anneal_opts_t *opts,
+                  int chains, int threads, int iters, int exchange, int huge,
+                  double seconds){
+  if (chains > threads) chains = threads;
+  if (exchange < 1) exchange = 1;
+  chain_t *chain = (chain_t *)calloc(chains, sizeof(chain_t));
+  // best routes so far
+  best_routes_t best;
+  best_init(&best, numWires);
+  const double stopAt = omp_get_wtime() + seconds;
+  double longest = 0;
+  int stop = seconds <= 0 && iters <= 0;
+
+  omp_set_max_active_levels(2);
+  #pragma omp parallel num_threads(chains) default(shared)
+  {
+    int k = omp_get_thread_num();
+    chain_t *c = &chain[k];
+    path_t tmp;
+    // spread the threads over the groups, remainder to the first ones
+    omp_set_num_threads(threads / chains + (k < threads % chains ? 1 : 0));
+    c->opts = *opts;
+    c->opts.seeded = 1;
+    c->opts.seed = opts->seed + 7919u * (unsigned int)k;
+    c->opts.verbose = 0;
+    if (k != 0) c->opts.waves = NULL; // planned for chain 0's board
+    // SA_prob ladder around the requested value: (2k+1)/chains * SA_prob
+    c->opts.SA_prob = opts->SA_prob * (2*k + 1) / chains;
+    if (c->opts.SA_prob > 1.0) c->opts.SA_prob = 1.0;
+    if (k == 0){
+      c->costs = costs;
+      c->wires = wires;
+    }
+    else if (newChain(c, costs, wires, numWires, huge)){
+      printf("Portfolio chain %d: out of memory, skipped\n", k);
+      c->failed = 1;
+    }
+    #pragma omp barrier
+    for (int it = 0; !stop; it += exchange){
+      int last = seconds > 0 || it + exchange < iters ? it + exchange : iters;
+      double roundStart = omp_get_wtime();
+      if (!c->failed){
+        anneal(c->costs, c->wires, numWires, &c->opts, it, last);
+        waves_relayout(c->opts.waves, c->costs, c->wires, numWires);
+        updateBoard(c->costs);
+        c->max = c->costs->currentMax;
+        c->aggr = c->costs->currentAggrTotal;
+      }
+      #pragma omp barrier
+      #pragma omp single
+      {
+        exchangeRound(chain, chains, numWires, last, &best, &tmp);
+        double round = omp_get_wtime() - roundStart;
+        if (round > longest) longest = round;
+        stop = seconds > 0 ? !stepFits(stopAt, longest) : last >= iters;
+      } /* implicit barrier */
+    }
+    if (k != 0 && !c->failed){
+      freeBoard(&c->own, &c->boardMem);
+      region_free(&c->wireMem);
+      region_free(&c->pathMem);
+    }
+  }
+  if (seconds > 0)
+    printf("Portfolio: deadline reached, %d improvements copied %lld routes\n",
+           best.kept - 1, best.copied - numWires);
+  best_restore(&best, wires);
+  best_free(&best);
+  free(chain);
+}
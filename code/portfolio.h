@@ -0,0 +1,28 @@
+/**
+ * Parallel VLSI Wire Routing via OpenMP
+ * Jack Kasbeer (jkasbeer), Qifang Cai (qcai)
+ *
+ * Portfolio mode: independent annealing chains on groups of threads, with
+ * periodic replica exchange between them.
+ */
+
+#ifndef __PORTFOLIO_H__
+#define __PORTFOLIO_H__
+
+#include "wireroute.h"
+
+/* runPortfolio *
+ * Split 'threads' into 'chains' groups.  Chain 0 anneals the given board
+ * and wires, the others their own copies, each with its own seed and
+ * SA_prob.  Every 'exchange' iterations the chains are scored and
+ * neighbouring chains swap routes when the hotter one is ahead.  With
+ * 'seconds' > 0 rounds go on until that much wall-clock time has passed
+ * (no round is started that the slowest so far says would not fit)
+ * instead of for 'iters' iterations.  On return 'wires' hold the best
+ * routes any chain reached (the board is stale).
+ */
+void runPortfolio(cost_t *costs, wire_t *wires, int numWires, const anneal_opts_t *opts,
+                  int chains, int threads, int iters, int exchange, int huge,
+                  double seconds);
+
+#endif /* __PORTFOLIO_H__ */
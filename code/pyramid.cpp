@@ -0,0 +1,92 @@
+/**
+ * Parallel VLSI Wire Routing via OpenMP
+ * Jack Kasbeer (jkasbeer), Qifang Cai (qcai)
+ */
+
+#include "pyramid.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <omp.h>
+
+int write_pyramid(const char *filename, const cost_t *costs, int tile){
+  const int dimX = costs->dimX, dimY = costs->dimY;
+  std::vector<pyramid_level_t> level;
+  std::vector<pyramid_tile_t *> tiles;
+  pyramid_header_t hdr;
+  int64_t offset;
+
+  if (tile < 1) tile = 1;
+  // level shapes: keep halving until one tile covers the board
+  for (int cells = tile; ; cells *= 2){
+    pyramid_level_t l;
+    l.cells = cells;
+    l.tilesX = (dimX + cells - 1) / cells;
+    l.tilesY = (dimY + cells - 1) / cells;
+    l.pad = 0;
+    level.push_back(l);
+    tiles.push_back((pyramid_tile_t *)calloc((size_t)l.tilesX * l.tilesY, sizeof(pyramid_tile_t)));
+    if (l.tilesX == 1 && l.tilesY == 1) break;
+  }
+  offset = sizeof(hdr) + level.size() * sizeof(pyramid_level_t);
+  for (size_t k = 0; k < level.size(); k++){
+    level[k].offset = offset;
+    offset += (int64_t)level[k].tilesX * level[k].tilesY * sizeof(pyramid_tile_t);
+  }
+
+  /* Level 0: one tile row per iteration, so threads stream whole rows */
+  pyramid_tile_t *t0 = tiles[0];
+  const int tilesX0 = level[0].tilesX;
+  #pragma omp parallel for default(shared) schedule(dynamic)
+  for (int ty = 0; ty < level[0].tilesY; ty++){
+    pyramid_tile_t *rowTiles = &t0[(size_t)ty * tilesX0];
+    int yEnd = (ty + 1) * tile < dimY ? (ty + 1) * tile : dimY;
+    for (int y = ty * tile; y < yEnd; y++){
+      for (int x = 0; x < dimX; x++){
+        int val = boardCell(costs, x, y)->val;
+        pyramid_tile_t *t = &rowTiles[x / tile];
+        if (val > t->max) t->max = val;
+        t->sum += val;
+      }
+    }
+  }
+  /* Level k: merge 2x2 tiles of level k-1 */
+  for (size_t k = 1; k < level.size(); k++){
+    const pyramid_level_t lo = level[k-1], hi = level[k];
+    const pyramid_tile_t *src = tiles[k-1];
+    pyramid_tile_t *dst = tiles[k];
+    #pragma omp parallel for default(shared) schedule(static)
+    for (int ty = 0; ty < hi.tilesY; ty++){
+      for (int tx = 0; tx < hi.tilesX; tx++){
+        pyramid_tile_t *t = &dst[(size_t)ty * hi.tilesX + tx];
+        for (int sy = 2*ty; sy < 2*ty + 2 && sy < lo.tilesY; sy++){
+          for (int sx = 2*tx; sx < 2*tx + 2 && sx < lo.tilesX; sx++){
+            const pyramid_tile_t *s = &src[(size_t)sy * lo.tilesX + sx];
+            if (s->max > t->max) t->max = s->max;
+            t->sum += s->sum;
+          }
+        }
+      }
+    }
+  }
+
+  FILE *out = fopen(filename, "wb");
+  if (out == NULL){
+    for (size_t k = 0; k < tiles.size(); k++) free(tiles[k]);
+    return -1;
+  }
+  memcpy(hdr.magic, PYRAMID_MAGIC, sizeof(hdr.magic));
+  hdr.dimX = dimX;
+  hdr.dimY = dimY;
+  hdr.tile = tile;
+  hdr.levels = (int32_t)level.size();
+  fwrite(&hdr, sizeof(hdr), 1, out);
+  fwrite(&level[0], sizeof(pyramid_level_t), level.size(), out);
+  for (size_t k = 0; k < level.size(); k++){
+    fwrite(tiles[k], sizeof(pyramid_tile_t), (size_t)level[k].tilesX * level[k].tilesY, out);
+    free(tiles[k]);
+  }
+  fclose(out);
+  return 0;
+}
@@ -0,0 +1,53 @@
+/**
+ * Parallel VLSI Wire Routing via OpenMP
+ * Jack Kasbeer (jkasbeer), Qifang Cai (qcai)
+ *
+ * Multi-resolution tiled cost output.  Level 0 tiles cover tile x tile
+ * cells of the board, every further level merges 2x2 tiles of the one
+ * below, up to a single tile.  The file is laid out for random access:
+ *
+ *   pyramid_header_t
+ *   pyramid_level_t[levels]          (level 0 first)
+ *   pyramid_tile_t[tilesX * tilesY]  per level, row-major, at 'offset'
+ *
+ * so a viewer can seek straight to the tiles of one zoom level and region.
+ */
+
+#ifndef __PYRAMID_H__
+#define __PYRAMID_H__
+
+#include <stdint.h>
+#include "wireroute.h"
+
+#define PYRAMID_MAGIC "WRP1"
+
+typedef struct
+{
+  char magic[4];      // PYRAMID_MAGIC, no terminator
+  int32_t dimX;
+  int32_t dimY;
+  int32_t tile;       // level 0 tile edge, in cells
+  int32_t levels;
+} pyramid_header_t;
+
+typedef struct
+{
+  int32_t cells;      // tile edge at this level, in cells
+  int32_t tilesX;
+  int32_t tilesY;
+  int32_t pad;
+  int64_t offset;     // file offset of the level's first tile
+} pyramid_level_t;
+
+typedef struct
+{
+  int32_t max;        // largest cell value in the tile
+  int32_t pad;
+  int64_t sum;        // sum of the tile's cell values
+} pyramid_tile_t;
+
+/* Build the pyramid of a laid out board in parallel and write it.
+ * Returns 0 on success. */
+int write_pyramid(const char *filename, const cost_t *costs, int tile);
+
+#endif /* __PYRAMID_H__ */
@@ -0,0 +1,511 @@
+/**
+ * Parallel VLSI Wire Routing via OpenMP
+ * Jack Kasbeer (jkasbeer), Qifang Cai (qcai)
+ *
+ * Route evaluation kernels.  Every route shape and segment direction is a
+ * template parameter so the per-cell loops compile down to a fixed stride
+ * with no shape or direction tests inside them.
+ */
+
+#ifndef __ROUTEKERNEL_H__
+#define __ROUTEKERNEL_H__
+
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include "wireroute.h"
+
+/* route_shape_t *
+ * The five route shapes a wire can take between its end points
+ */
+typedef enum
+{
+  ROUTE_STRAIGHT = 0, // no bends
+  ROUTE_L_HORIZ,      // horizontal, then vertical at column e_x
+  ROUTE_L_VERT,       // vertical, then horizontal at row e_y
+  ROUTE_Z_HORIZ,      // horizontal, vertical at bend column, horizontal
+  ROUTE_Z_VERT        // vertical, horizontal at bend row, vertical
+} route_shape_t;
+
+// a cell's value, not counting wire_n's own contribution (unlocked: see
+// cost_cell_t for what a commit in flight can do to it)
+static inline int cellValue(const cost_cell_t *c, int wire_n){
+  const int n = __atomic_load_n(&c->wire, __ATOMIC_RELAXED);
+  const int val = __atomic_load_n(&c->val, __ATOMIC_RELAXED);
+  for (int count = 0; count < n; count++){
+    if(wire_n == __atomic_load_n(&c->list[count], __ATOMIC_RELAXED))
+      return val-1;
+  }
+  return val;
+}
+
+// read a value in the board, not counting wire_n's own contribution
+static inline int readBoard(const cost_t *board, int x, int y, int wire_n){
+  return cellValue(boardCell(board, x, y), wire_n);
+}
+
+/* forRow / forCol *
+ * visit(cell) for cells [s, e) of a row or column, walking in direction
+ * DIR, with one directory lookup per tile crossed rather than per cell
+ */
+template <int DIR, typename F>
+static inline void forRow(const cost_t *board, int y, int s_x, int e_x, F visit){
+  const int mask = BOARD_TILE - 1;
+  const int rowBase = (y & mask) << BOARD_TILE_SHIFT;
+  int x = s_x;
+  while (x != e_x){
+    const cost_cell_t *tile = board->tiles[tileIndex(board, x, y)] + rowBase;
+    int stop = DIR > 0 ? (x | mask) + 1 : (x & ~mask) - 1; // first x past the tile
+    if ((DIR > 0 && stop > e_x) || (DIR < 0 && stop < e_x)) stop = e_x;
+    for (; x != stop; x += DIR) visit(&tile[x & mask]);
+  }
+}
+
+template <int DIR, typename F>
+static inline void forCol(const cost_t *board, int x, int s_y, int e_y, F visit){
+  const int mask = BOARD_TILE - 1;
+  int y = s_y;
+  while (y != e_y){
+    const cost_cell_t *tile = board->tiles[tileIndex(board, x, y)] + (x & mask);
+    int stop = DIR > 0 ? (y | mask) + 1 : (y & ~mask) - 1;
+    if ((DIR > 0 && stop > e_y) || (DIR < 0 && stop < e_y)) stop = e_y;
+    for (; y != stop; y += DIR) visit(&tile[(y & mask) << BOARD_TILE_SHIFT]);
+  }
+}
+
+// fold one cell value into a running value_t
+static inline void addCell(value_t *v, int val){
+  if(v->m < val) v->m = val;
+  if(val > 1) v->aggr_max += val;
+}
+
+// a candidate only replaces the current best if it wins on both counts
+static inline bool betterValue(value_t cand, value_t best){
+  return cand.m < best.m && cand.aggr_max < best.aggr_max;
+}
+
+// cells [s_x, e_x) of row y, walking in direction DIR
+template <int DIR>
+static inline value_t readRow(const cost_t *board, int y, int s_x, int e_x, int wire_n){
+  value_t result = {0, 0};
+  forRow<DIR>(board, y, s_x, e_x, [&](const cost_cell_t *c){
+    addCell(&result, cellValue(c, wire_n));
+  });
+  return result;
+}
+
+// cells [s_y, e_y) of column x, walking in direction DIR
+template <int DIR>
+static inline value_t readCol(const cost_t *board, int x, int s_y, int e_y, int wire_n){
+  value_t result = {0, 0};
+  forCol<DIR>(board, x, s_y, e_y, [&](const cost_cell_t *c){
+    addCell(&result, cellValue(c, wire_n));
+  });
+  return result;
+}
+
+/* readBlock *
+ * Middle segments of neighbouring candidates, a tile's width at a time:
+ * lanes [lo, hi) of the tile aligned block at 'base' (columns base + l
+ * when COLS, else rows base + l), each over [s, e) of the other axis
+ * walked in direction DIR, into out[l - lo].  Every step loads one row of
+ * the tile's packed value plane (tileRows for columns, tileCols for rows)
+ * and folds it into a sum and max per lane, so the lanes are independent
+ * chains the compiler can vectorize instead of one long dependent chain
+ * per candidate.  The planes count wire_n too: the lanes its own path
+ * 'own' crosses on a step are read again with cellValue.
+ * A lane is dead once its max reaches limM[l] or its sum limA[l] (see
+ * laneLimit); when every lane is dead the walk stops, leaving partial
+ * values that are still lower bounds of the full ones.
+ */
+template <bool COLS, int DIR>
+static inline void readBlock(const cost_t *board, int base, int lo, int hi, int s, int e,
+                             const path_t *own, int wire_n, const int *limM,
+                             const int *limA, value_t *out){
+  const int mask = BOARD_TILE - 1;
+  const int step = COLS ? 1 : BOARD_TILE; // between lanes inside a tile
+  const int A = COLS ? 0 : 1;             // lane axis (x for columns)
+  int sum[BOARD_TILE] = {0}, mx[BOARD_TILE] = {0}, val[BOARD_TILE];
+  // own path as up to three segments, lane axis range [segLo, segHi]
+  // at walk axis range [segFrom, segTo]
+  int segLo[3], segHi[3], segFrom[3], segTo[3], numSegs = 0;
+  {
+    int pts[8], n = 0;
+    pts[n++] = own->bounds[0];
+    pts[n++] = own->bounds[1];
+    for (int b = 0; b < own->numBends; b++){
+      pts[n++] = own->bends[2*b];
+      pts[n++] = own->bends[2*b + 1];
+    }
+    pts[n++] = own->bounds[2];
+    pts[n++] = own->bounds[3];
+    for (int q = 0; q + 2 < n; q += 2){
+      segLo[numSegs] = std::min(pts[q + A], pts[q + 2 + A]) - base;
+      segHi[numSegs] = std::max(pts[q + A], pts[q + 2 + A]) - base;
+      segFrom[numSegs] = std::min(pts[q + 1 - A], pts[q + 3 - A]);
+      segTo[numSegs] = std::max(pts[q + 1 - A], pts[q + 3 - A]);
+      if (segHi[numSegs] >= lo && segLo[numSegs] < hi) numSegs++;
+    }
+  }
+  int p = s;
+  while (p != e){
+    int alive = 0;
+    #pragma omp simd reduction(|:alive)
+    for (int l = 0; l < BOARD_TILE; l++) alive |= (mx[l] < limM[l]) & (sum[l] < limA[l]);
+    if (!alive) break;
+    const cost_cell_t *tile = board->tiles[COLS ? tileIndex(board, base, p)
+                                                : tileIndex(board, p, base)];
+    int stop = DIR > 0 ? (p | mask) + 1 : (p & ~mask) - 1; // first p past the tile
+    if ((DIR > 0 && stop > e) || (DIR < 0 && stop < e)) stop = e;
+    const int *plane = COLS ? tileRows(tile) : tileCols(tile);
+    for (; p != stop; p += DIR){
+      const int *row = plane + ((p & mask) << BOARD_TILE_SHIFT);
+      for (int l = 0; l < BOARD_TILE; l++) val[l] = __atomic_load_n(&row[l], __ATOMIC_RELAXED);
+      for (int g = 0; g < numSegs; g++){
+        if (p < segFrom[g] || p > segTo[g]) continue;
+        const cost_cell_t *line = tile + (COLS ? (p & mask) << BOARD_TILE_SHIFT
+                                               : (p & mask));
+        for (int l = std::max(segLo[g], lo); l <= segHi[g] && l < hi; l++)
+          val[l] = cellValue(&line[l * step], wire_n);
+      }
+      #pragma omp simd
+      for (int l = 0; l < BOARD_TILE; l++){
+        mx[l] = mx[l] > val[l] ? mx[l] : val[l];
+        sum[l] += val[l] > 1 ? val[l] : 0;
+      }
+    }
+  }
+  for (int l = lo; l < hi; l++){
+    out[l - lo].aggr_max = sum[l];
+    out[l - lo].m = mx[l];
+  }
+}
+
+/* laneLimit *
+ * A Z route is its two fixed segments and end cell ('fixed') plus its
+ * middle segment, and every cell only raises its value.  So it can only
+ * beat 'best' while the middle segment stays under this limit (a limit
+ * of 0 means it cannot beat it at all).
+ */
+static inline void laneLimit(value_t fixed, value_t best, int *limM, int *limA){
+  *limM = fixed.m < best.m ? best.m : 0;
+  *limA = best.aggr_max - fixed.aggr_max;
+}
+
+/* sweepBlocks *
+ * Z candidates [lo, hi) of one bend axis, in sweep order: the bend of
+ * candidate k is a + k*DA across the lanes, its middle segment runs over
+ * [s, e) in direction DB, and its fixed part is pre[k] + suf[k] + endVal.
+ * Candidates are read a block of lanes at a time (readBlock) against the
+ * best value at the start of the block, then handed to tryOne(k, mid) in
+ * order.  A block whose candidates cannot win is not read at all, and a
+ * partly read one only stops once none can, so tryOne makes the same
+ * choices as on the full middle segments.
+ */
+template <bool COLS, int DA, int DB, typename F>
+static inline void sweepBlocks(const cost_t *board, int a, int lo, int hi, int s, int e,
+                               const value_t *pre, const value_t *suf, int endVal,
+                               const path_t *own, int wire_n, const value_t *best,
+                               F tryOne){
+  const int mask = BOARD_TILE - 1;
+  int limM[BOARD_TILE], limA[BOARD_TILE];
+  value_t mid[BOARD_TILE];
+  int k = lo;
+  while (k < hi){
+    const int base = (a + k*DA) & ~mask;
+    int kEnd = k + (DA > 0 ? base + BOARD_TILE - (a + k*DA) : a + k*DA - base + 1);
+    if (kEnd > hi) kEnd = hi;
+    const int l0 = a + k*DA - base, l1 = a + (kEnd - 1)*DA - base;
+    const int laneLo = l0 < l1 ? l0 : l1, laneHi = (l0 < l1 ? l1 : l0) + 1;
+    for (int l = 0; l < BOARD_TILE; l++) limM[l] = limA[l] = 0;
+    for (int j = k; j < kEnd; j++){
+      value_t fixed = combineValue(pre[j], suf[j]);
+      addCell(&fixed, endVal);
+      laneLimit(fixed, *best, &limM[a + j*DA - base], &limA[a + j*DA - base]);
+    }
+    readBlock<COLS, DB>(board, base, laneLo, laneHi, s, e, own, wire_n, limM, limA, mid);
+    for (int j = k; j < kEnd; j++) tryOne(j, mid[a + j*DA - base - laneLo]);
+    k = kEnd;
+  }
+}
+
+/* evalRoute *
+ * Cost of one route of shape S.  DX/DY are the directions from start to end
+ * (either may be 1 when the wire is straight along that axis).  (b_x, b_y)
+ * is the bend column for ROUTE_Z_HORIZ and the bend row for ROUTE_Z_VERT;
+ * the other shapes bend only at the corners.
+ */
+template <route_shape_t S, int DX, int DY>
+static inline value_t evalRoute(const cost_t *board, int s_x, int s_y, int e_x, int e_y,
+                                int b_x, int b_y, int wire_n){
+  value_t result;
+  switch (S) {
+    case ROUTE_STRAIGHT:
+    case ROUTE_L_HORIZ:
+      result = combineValue(readRow<DX>(board, s_y, s_x, e_x, wire_n),
+                            readCol<DY>(board, e_x, s_y, e_y, wire_n));
+      break;
+    case ROUTE_L_VERT:
+      result = combineValue(readCol<DY>(board, s_x, s_y, e_y, wire_n),
+                            readRow<DX>(board, e_y, s_x, e_x, wire_n));
+      break;
+    case ROUTE_Z_HORIZ:
+      result = combineValue(readRow<DX>(board, s_y, s_x, b_x, wire_n),
+                            readCol<DY>(board, b_x, s_y, e_y, wire_n));
+      result = combineValue(result, readRow<DX>(board, e_y, b_x, e_x, wire_n));
+      break;
+    case ROUTE_Z_VERT:
+      result = combineValue(readCol<DY>(board, s_x, s_y, b_y, wire_n),
+                            readRow<DX>(board, b_y, s_x, e_x, wire_n));
+      result = combineValue(result, readCol<DY>(board, e_x, b_y, e_y, wire_n));
+      break;
+  }
+  addCell(&result, readBoard(board, e_x, e_y, wire_n));
+  return result;
+}
+
+// pick the direction specialization of evalRoute at runtime
+template <route_shape_t S>
+static inline value_t evalRouteDir(const cost_t *board, int s_x, int s_y, int e_x, int e_y,
+                                   int b_x, int b_y, int wire_n){
+  if (e_x >= s_x){
+    if (e_y >= s_y) return evalRoute<S, 1, 1>(board, s_x, s_y, e_x, e_y, b_x, b_y, wire_n);
+    return evalRoute<S, 1, -1>(board, s_x, s_y, e_x, e_y, b_x, b_y, wire_n);
+  }
+  if (e_y >= s_y) return evalRoute<S, -1, 1>(board, s_x, s_y, e_x, e_y, b_x, b_y, wire_n);
+  return evalRoute<S, -1, -1>(board, s_x, s_y, e_x, e_y, b_x, b_y, wire_n);
+}
+
+/* walkPath *
+ * Call visit(x, y) once for every cell a path covers, in the same order
+ * layoutWire lays it down (bends once, end point last)
+ */
+template <typename F>
+static inline void walkPath(const path_t *path, F visit){
+  int pts[8];
+  int n = 0;
+  pts[n++] = path->bounds[0];
+  pts[n++] = path->bounds[1];
+  for (int b = 0; b < path->numBends; b++){
+    pts[n++] = path->bends[2*b];
+    pts[n++] = path->bends[2*b + 1];
+  }
+  pts[n++] = path->bounds[2];
+  pts[n++] = path->bounds[3];
+  for (int p = 0; p + 2 < n; p += 2){
+    int x = pts[p], y = pts[p+1];
+    int dx = pts[p+2] > x ? 1 : (pts[p+2] < x ? -1 : 0);
+    int dy = pts[p+3] > y ? 1 : (pts[p+3] < y ? -1 : 0);
+    while (x != pts[p+2] || y != pts[p+3]){
+      visit(x, y);
+      x += dx;
+      y += dy;
+    }
+  }
+  visit(pts[n-2], pts[n-1]);
+}
+
+// k range [*lo, *hi) of the bends s + k*D that fall in [winLo, winHi)
+template <int D>
+static inline void windowSteps(int s, int winLo, int winHi, int *lo, int *hi){
+  int a = D > 0 ? winLo - s : s - winHi + 1;
+  int b = D > 0 ? winHi - s : s - winLo + 1;
+  if (a > *lo) *lo = a;
+  if (b < *hi) *hi = b;
+}
+
+/* pickSteps *
+ * 'count' of the steps [lo, hi), ascending, chosen the way 'sampling' says
+ * (at most 'count' for SAMPLE_RANDOM, which may draw a step twice).
+ * score(k) ranks steps for SAMPLE_CONGESTION, lower first.
+ */
+template <typename S>
+static inline void pickSteps(int sampling, int lo, int hi, int count, unsigned int *salt,
+                             S score, std::vector<int> *out){
+  const int n = hi - lo;
+  out->clear();
+  if (n <= 0 || count <= 0) return;
+  if (count >= n){
+    for (int k = lo; k < hi; k++) out->push_back(k);
+    return;
+  }
+  switch (sampling){
+    case SAMPLE_RANDOM:
+      for (int j = 0; j < count; j++) out->push_back(lo + rand_r(salt) % n);
+      std::sort(out->begin(), out->end());
+      out->erase(std::unique(out->begin(), out->end()), out->end());
+      break;
+    case SAMPLE_CONGESTION:
+      for (int k = lo; k < hi; k++) out->push_back(k);
+      std::nth_element(out->begin(), out->begin() + count, out->end(), [&](int a, int b){
+        value_t va = score(a), vb = score(b);
+        return va.m < vb.m || (va.m == vb.m && va.aggr_max < vb.aggr_max);
+      });
+      out->resize(count);
+      std::sort(out->begin(), out->end());
+      break;
+    default: { // every (n / count)-th step from a random start
+      const double stride = (double)n / count;
+      const double first = stride * (rand_r(salt) % 1024) / 1024.0;
+      for (int j = 0; j < count; j++) out->push_back(lo + (int)(first + j * stride));
+    }
+  }
+}
+
+/* sweepRoutesDir *
+ * Try both L routes, then every bend column, then every bend row, in that
+ * order, keeping the first candidate that beats 'best' (with a corridor,
+ * only the bend columns and rows inside it).  The two row segments shared
+ * by all bend-column candidates (row s_y up to the bend, row e_y from the
+ * bend) are scanned once into prefix/suffix tables, and likewise for the
+ * column segments of the bend-row sweep.  A full sweep reads the middle
+ * segments a tile's width of candidates at a time (sweepBlocks): a block
+ * whose fixed segments alone cannot beat 'best' is not read at all, and
+ * the rest stop as soon as none of their candidates can.  With a budget
+ * smaller than the bend positions left, only that many are tried, split
+ * between columns and rows by their share and picked by ctl->sampling;
+ * each of those whose fixed segments can still win is walked on its own.
+ */
+template <int DX, int DY>
+static void sweepRoutesDir(const cost_t *board, const path_t *path, int wire_n,
+                           value_t *best, path_t *next, sweep_ctl_t *ctl){
+  const int s_x = path->bounds[0], s_y = path->bounds[1];
+  const int e_x = path->bounds[2], e_y = path->bounds[3];
+  const int dx = (e_x - s_x) * DX, dy = (e_y - s_y) * DY;
+  const int endVal = readBoard(board, e_x, e_y, wire_n);
+  value_t v;
+  int k;
+  int colLo = 1, colHi = dx, rowLo = 1, rowHi = dy;
+  const corridor_t *win = ctl->win;
+  if (win != NULL){
+    windowSteps<DX>(s_x, win->colLo, win->colHi, &colLo, &colHi);
+    windowSteps<DY>(s_y, win->rowLo, win->rowHi, &rowLo, &rowHi);
+  }
+  const int numCols = colHi > colLo ? colHi - colLo : 0;
+  const int numRows = rowHi > rowLo ? rowHi - rowLo : 0;
+  ctl->total += dx + dy;  // both L routes and dx - 1 columns, dy - 1 rows
+
+  // rowPre[k]: row s_y over [s_x, s_x+k*DX); rowSuf[k]: row e_y over [s_x+k*DX, e_x)
+  // colPre[k]: col s_x over [s_y, s_y+k*DY); colSuf[k]: col e_x over [s_y+k*DY, e_y)
+  std::vector<value_t> scratch(2*(dx + 1) + 2*(dy + 1));
+  value_t *rowPre = &scratch[0];
+  value_t *rowSuf = rowPre + dx + 1;
+  value_t *colPre = rowSuf + dx + 1;
+  value_t *colSuf = colPre + dy + 1;
+
+  rowPre[0].aggr_max = rowPre[0].m = 0;
+  k = 0;
+  forRow<DX>(board, s_y, s_x, e_x, [&](const cost_cell_t *c){
+    rowPre[k+1] = rowPre[k];
+    addCell(&rowPre[k+1], cellValue(c, wire_n));
+    k++;
+  });
+  rowSuf[dx].aggr_max = rowSuf[dx].m = 0;
+  k = dx;
+  forRow<-DX>(board, e_y, e_x - DX, s_x - DX, [&](const cost_cell_t *c){
+    rowSuf[k-1] = rowSuf[k];
+    addCell(&rowSuf[k-1], cellValue(c, wire_n));
+    k--;
+  });
+  colPre[0].aggr_max = colPre[0].m = 0;
+  k = 0;
+  forCol<DY>(board, s_x, s_y, e_y, [&](const cost_cell_t *c){
+    colPre[k+1] = colPre[k];
+    addCell(&colPre[k+1], cellValue(c, wire_n));
+    k++;
+  });
+  colSuf[dy].aggr_max = colSuf[dy].m = 0;
+  k = dy;
+  forCol<-DY>(board, e_x, e_y - DY, s_y - DY, [&](const cost_cell_t *c){
+    colSuf[k-1] = colSuf[k];
+    addCell(&colSuf[k-1], cellValue(c, wire_n));
+    k--;
+  });
+
+  // -> horizontal one bend
+  v = combineValue(rowPre[dx], colSuf[0]);
+  addCell(&v, endVal);
+  if (betterValue(v, *best)){
+    *best = v;
+    next->numBends = 1;
+    next->bends[0] = e_x;
+    next->bends[1] = s_y;
+  }
+  // -> vertical one bend
+  v = combineValue(colPre[dy], rowSuf[0]);
+  addCell(&v, endVal);
+  if (betterValue(v, *best)){
+    *best = v;
+    next->numBends = 1;
+    next->bends[0] = s_x;
+    next->bends[1] = e_y;
+  }
+  // horizontal path through bend column s_x + i*DX, its middle segment 'mid'
+  auto tryCol = [&](int i, value_t mid){
+    const int col = s_x + i*DX;
+    v = combineValue(combineValue(rowPre[i], mid), rowSuf[i]);
+    addCell(&v, endVal);
+    if (betterValue(v, *best)){
+      *best = v;
+      next->numBends = 2;
+      next->bends[0] = col;
+      next->bends[1] = s_y;
+      next->bends[2] = col;
+      next->bends[3] = e_y;
+    }
+  };
+  // vertical path through bend row s_y + i*DY, its middle segment 'mid'
+  auto tryRow = [&](int i, value_t mid){
+    const int row = s_y + i*DY;
+    v = combineValue(combineValue(colPre[i], mid), colSuf[i]);
+    addCell(&v, endVal);
+    if (betterValue(v, *best)){
+      *best = v;
+      next->numBends = 2;
+      next->bends[0] = s_x;
+      next->bends[1] = row;
+      next->bends[2] = e_x;
+      next->bends[3] = row;
+    }
+  };
+
+  if (ctl->budget <= 0 || numCols + numRows <= ctl->budget){
+    // calculate horizontal paths (sweep bend column), then vertical paths
+    // (sweep bend row), by blocks of middle segments
+    sweepBlocks<true, DX, DY>(board, s_x, colLo, colHi, s_y, e_y, rowPre, rowSuf, endVal,
+                              path, wire_n, best, tryCol);
+    sweepBlocks<false, DY, DX>(board, s_y, rowLo, rowHi, s_x, e_x, colPre, colSuf, endVal,
+                               path, wire_n, best, tryRow);
+    ctl->tried += 2 + numCols + numRows;
+    return;
+  }
+  // fixed segments and end cell of a bend column / row candidate
+  auto fixedCol = [&](int i){
+    value_t f = combineValue(rowPre[i], rowSuf[i]);
+    addCell(&f, endVal);
+    return f;
+  };
+  auto fixedRow = [&](int i){
+    value_t f = combineValue(colPre[i], colSuf[i]);
+    addCell(&f, endVal);
+    return f;
+  };
+  const int colBudget = (int)((long long)ctl->budget * numCols / (numCols + numRows));
+  std::vector<int> steps;
+  pickSteps(ctl->sampling, colLo, colHi, colBudget, &ctl->salt,
+            [&](int i){ return combineValue(rowPre[i], rowSuf[i]); }, &steps);
+  for (int c : steps){
+    if (betterValue(fixedCol(c), *best))
+      tryCol(c, readCol<DY>(board, s_x + c*DX, s_y, e_y, wire_n));
+  }
+  ctl->tried += 2 + steps.size();
+  pickSteps(ctl->sampling, rowLo, rowHi, ctl->budget - colBudget, &ctl->salt,
+            [&](int i){ return combineValue(colPre[i], colSuf[i]); }, &steps);
+  for (int r : steps){
+    if (betterValue(fixedRow(r), *best))
+      tryRow(r, readRow<DX>(board, s_y + r*DY, s_x, e_x, wire_n));
+  }
+  ctl->tried += steps.size();
+}
+
+#endif /* __ROUTEKERNEL_H__ */
@@ -0,0 +1,123 @@
+/**
+ * Parallel VLSI Wire Routing via OpenMP
+ * Jack Kasbeer (jkasbeer), Qifang Cai (qcai)
+ */
+
+#include "seglayout.h"
+#include <omp.h>
+
+void bins_init(seg_bins_t *b, const cost_t *costs){
+  b->threads = omp_get_max_threads();
+  b->bands = costs->tilesY;
+  b->bins = new std::vector<seg_t>[(size_t)b->threads * b->bands];
+}
+
+void bins_free(seg_bins_t *b){
+  delete[] b->bins;
+  b->bins = NULL;
+}
+
+// cells from a to b, b excluded, as an ascending [from, to) range
+static inline void cellRange(int a, int b, int *from, int *to){
+  if (a < b){
+    *from = a;
+    *to = b;
+  }
+  else{
+    *from = b + 1;
+    *to = a + 1;
+  }
+}
+
+/* cutWire *
+ * Drop one wire's cells into 'mine' (this thread's bins), split at band
+ * boundaries; same cells as layoutWire, the end point as its own segment
+ */
+static void cutWire(const path_t *path, int wire_n, std::vector<seg_t> *mine){
+  int pts[8];
+  int n = 0;
+  seg_t s;
+  s.wire = wire_n;
+  pts[n++] = path->bounds[0];
+  pts[n++] = path->bounds[1];
+  for (int b = 0; b < path->numBends; b++){
+    pts[n++] = path->bends[2*b];
+    pts[n++] = path->bends[2*b + 1];
+  }
+  pts[n++] = path->bounds[2];
+  pts[n++] = path->bounds[3];
+  for (int p = 0; p + 2 < n; p += 2){
+    if (pts[p+1] == pts[p+3]){ // horizontal: one band
+      if (pts[p] == pts[p+2]) continue;
+      s.line = pts[p+1];
+      s.vertical = 0;
+      cellRange(pts[p], pts[p+2], &s.from, &s.to);
+      mine[s.line >> BOARD_TILE_SHIFT].push_back(s);
+    }
+    else{ // vertical: a piece per band crossed
+      int from, to;
+      s.line = pts[p];
+      s.vertical = 1;
+      cellRange(pts[p+1], pts[p+3], &from, &to);
+      while (from < to){
+        int band = from >> BOARD_TILE_SHIFT;
+        int end = (band + 1) << BOARD_TILE_SHIFT;
+        s.from = from;
+        s.to = end < to ? end : to;
+        mine[band].push_back(s);
+        from = s.to;
+      }
+    }
+  }
+  s.line = pts[n-1];
+  s.vertical = 0;
+  s.from = pts[n-2];
+  s.to = pts[n-2] + 1;
+  mine[s.line >> BOARD_TILE_SHIFT].push_back(s);
+}
+
+// only this band's owner touches these cells: no lock
+static inline void addWire(cost_cell_t *c, int x, int y, int wire_n){
+  storeVal(c, x, y, c->val + 1);
+  if (c->wire < WIRE_MAX){
+    c->list[c->wire] = wire_n;
+    c->wire += 1;
+  }
+}
+
+void layoutBinned(cost_t *costs, wire_t *wires, int numWires, seg_bins_t *b){
+  const int bands = b->bands;
+  /* Pass 1: each thread cuts a static (so ascending) block of wires */
+  #pragma omp parallel default(shared) num_threads(b->threads)
+  {
+    std::vector<seg_t> *mine = &b->bins[(size_t)omp_get_thread_num() * bands];
+    for (int band = 0; band < bands; band++) mine[band].clear();
+    #pragma omp for schedule(static)
+    for (int w = 0; w < numWires; w++)
+      cutWire(wires[w].currentPath, w, mine);
+  } /* implicit barrier */
+
+  /* Pass 2: the owner of a band clears it, then applies every thread's
+   * segments for it in thread (so wire) order.  Bands go out by the same
+   * static tile rows allocBoard and clearBoard use, so each owner writes
+   * the tiles it first touched */
+  #pragma omp parallel for default(shared) schedule(static)
+  for (int band = 0; band < bands; band++){
+    for (int tx = 0; tx < costs->tilesX; tx++){
+      cost_cell_t *tile = costs->tiles[(size_t)band * costs->tilesX + tx];
+      if (tile != costs->zero) clearTile(tile);
+    }
+    for (int t = 0; t < b->threads; t++){
+      const std::vector<seg_t> &bin = b->bins[(size_t)t * bands + band];
+      for (size_t k = 0; k < bin.size(); k++){
+        const seg_t &s = bin[k];
+        if (s.vertical){
+          for (int y = s.from; y < s.to; y++) addWire(writeCell(costs, s.line, y), s.line, y, s.wire);
+        }
+        else{
+          for (int x = s.from; x < s.to; x++) addWire(writeCell(costs, x, s.line), x, s.line, s.wire);
+        }
+      }
+    }
+  }
+}
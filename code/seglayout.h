@@ -0,0 +1,45 @@
+/**
+ * Parallel VLSI Wire Routing via OpenMP
+ * Jack Kasbeer (jkasbeer), Qifang Cai (qcai)
+ *
+ * Owner-computes board layout: wires are cut into per-band segments first,
+ * then every band of rows is cleared and filled by the one thread that owns
+ * it, with plain stores instead of cell locks.
+ */
+
+#ifndef __SEGLAYOUT_H__
+#define __SEGLAYOUT_H__
+
+#include <vector>
+#include "wireroute.h"
+
+/* seg_t *
+ * Cells [from, to) of one row or column, inside one band, for one wire
+ */
+typedef struct
+{
+  int wire;
+  int line;      // the row (horizontal) or column (vertical)
+  int from;
+  int to;
+  int vertical;
+} seg_t;
+
+/* seg_bins_t *
+ * bins[t * bands + b]: segments thread t cut for band b.  A band is one
+ * row of board tiles, so it is contiguous in a dense board.
+ */
+typedef struct
+{
+  int threads;
+  int bands;
+  std::vector<seg_t> *bins;
+} seg_bins_t;
+
+void bins_init(seg_bins_t *b, const cost_t *costs);
+void bins_free(seg_bins_t *b);
+/* clearBoard + layoutBoard.  Cells list their wires in wire order whatever
+ * the thread count (with one thread, layoutBoard's order) */
+void layoutBinned(cost_t *costs, wire_t *wires, int numWires, seg_bins_t *b);
+
+#endif /* __SEGLAYOUT_H__ */
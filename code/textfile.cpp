@@ -0,0 +1,85 @@
+/**
+ * Parallel VLSI Wire Routing via OpenMP
+ * Jack Kasbeer (jkasbeer), Qifang Cai (qcai)
+ */
+
+#include "textfile.h"
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <omp.h>
+
+int map_file(mapped_file_t *f, const char *path){
+  struct stat st;
+  int fd = open(path, O_RDONLY);
+  f->data = NULL;
+  f->size = 0;
+  if (fd < 0) return -1;
+  if (fstat(fd, &st) != 0){
+    close(fd);
+    return -1;
+  }
+  f->size = (size_t)st.st_size;
+  if (f->size != 0){
+    void *p = mmap(NULL, f->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (p == MAP_FAILED){
+      close(fd);
+      return -1;
+    }
+    madvise(p, f->size, MADV_SEQUENTIAL);
+    f->data = (const char *)p;
+  }
+  close(fd); // the mapping keeps the file alive
+  return 0;
+}
+
+void unmap_file(mapped_file_t *f){
+  if (f->data != NULL) munmap((void *)f->data, f->size);
+  f->data = NULL;
+  f->size = 0;
+}
+
+void prefetch_file(const mapped_file_t *f){
+  if (f->data != NULL) madvise((void *)f->data, f->size, MADV_WILLNEED);
+}
+
+/* split_lines *
+ * Pass 1: every thread counts the newlines in its block of bytes.
+ * Pass 2: a prefix over the counts tells each thread where its lines go.
+ */
+long split_lines(const mapped_file_t *f, size_t **starts){
+  const char *data = f->data;
+  const size_t size = f->size;
+  int nthreads = omp_get_max_threads();
+  long *before = (long *)calloc(nthreads + 1, sizeof(long));
+  long lines;
+
+  #pragma omp parallel default(shared)
+  {
+    int t = omp_get_thread_num();
+    int nt = omp_get_num_threads();
+    size_t lo = size * t / nt, hi = size * (t + 1) / nt;
+    long count = 0;
+    // a newline at the last byte does not start a line
+    for (size_t i = lo; i < hi; i++)
+      if (data[i] == '\n' && i + 1 < size) count++;
+    before[t + 1] = count;
+    #pragma omp barrier
+    #pragma omp single
+    {
+      for (int b = 1; b <= nt; b++) before[b] += before[b - 1];
+      lines = (size != 0) ? before[nt] + 1 : 0;
+      *starts = (size_t *)malloc((lines + 1) * sizeof(size_t));
+      (*starts)[0] = 0;
+      (*starts)[lines] = size;
+    } /* implicit barrier */
+    long next = before[t] + 1;
+    for (size_t i = lo; i < hi; i++)
+      if (data[i] == '\n' && i + 1 < size) (*starts)[next++] = i + 1;
+  }
+  free(before);
+  return lines;
+}
@@ -0,0 +1,54 @@
+/**
+ * Parallel VLSI Wire Routing via OpenMP
+ * Jack Kasbeer (jkasbeer), Qifang Cai (qcai)
+ *
+ * Memory-mapped text files, split into lines and parsed in parallel.
+ */
+
+#ifndef __TEXTFILE_H__
+#define __TEXTFILE_H__
+
+#include <stddef.h>
+
+/* mapped_file_t *
+ * A read-only mapping of a whole file (not NUL terminated)
+ */
+typedef struct
+{
+  const char *data;
+  size_t size;
+} mapped_file_t;
+
+/* Returns 0 on success */
+int map_file(mapped_file_t *f, const char *path);
+void unmap_file(mapped_file_t *f);
+/* Start reading the whole file in (returns at once, the kernel reads on) */
+void prefetch_file(const mapped_file_t *f);
+
+/* Offset of the first byte of every line (a trailing newline does not
+ * start a new line).  *starts is malloc'd with one extra entry holding
+ * f->size, so line i is [starts[i], starts[i+1]).  Returns the line count. */
+long split_lines(const mapped_file_t *f, size_t **starts);
+
+/* Parse the next integer in [*p, end), skipping blanks and newlines.
+ * Returns 1 and advances *p on success, 0 if only blanks were left. */
+static inline int next_int(const char **p, const char *end, long long *out){
+  const char *c = *p;
+  long long v = 0;
+  int neg = 0;
+  while (c < end && (*c == ' ' || *c == '\t' || *c == '\r' || *c == '\n')) c++;
+  if (c < end && *c == '-'){
+    neg = 1;
+    c++;
+  }
+  if (c >= end || *c < '0' || *c > '9'){
+    *p = c;
+    return 0;
+  }
+  while (c < end && *c >= '0' && *c <= '9') v = v * 10 + (*c++ - '0');
+  *out = neg ? -v : v;
+  *p = c;
+  return 1;
+}
+
+#endif /* __TEXTFILE_H__ */
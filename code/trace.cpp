@@ -0,0 +1,168 @@
+/**
+ * Parallel VLSI Wire Routing via OpenMP
+ * Jack Kasbeer (jkasbeer), Qifang Cai (qcai)
+ */
+
+#include "trace.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+#include <omp.h>
+
+// route word of a path (its unused bend slots are not kept)
+static inline uint32_t encodeRoute(const path_t *p){
+  uint32_t word = (uint32_t)p->numBends;
+  if (p->numBends == 0) return word;
+  if (p->bends[1] != p->bounds[1]) word |= TRACE_VERTICAL; // does not leave along row s_y
+  if (p->numBends == 2)
+    word |= (uint32_t)((word & TRACE_VERTICAL) ? p->bends[1] : p->bends[0])
+            << TRACE_COORD_SHIFT;
+  return word;
+}
+
+// bends of a path with these bounds from its route word
+static inline void decodeRoute(uint32_t word, path_t *p){
+  const int s_x = p->bounds[0], s_y = p->bounds[1];
+  const int e_x = p->bounds[2], e_y = p->bounds[3];
+  const int c = (int)(word >> TRACE_COORD_SHIFT);
+  const int vertical = (word & TRACE_VERTICAL) != 0;
+  p->numBends = word & 3;
+  if (p->numBends == 1){
+    p->bends[0] = vertical ? s_x : e_x;
+    p->bends[1] = vertical ? e_y : s_y;
+    p->bends[2] = e_x;
+    p->bends[3] = e_y;
+  }
+  else if (p->numBends == 2){
+    p->bends[0] = vertical ? s_x : c;
+    p->bends[1] = vertical ? c : s_y;
+    p->bends[2] = vertical ? e_x : c;
+    p->bends[3] = vertical ? c : e_y;
+  }
+}
+
+int trace_record(route_trace_t *t, const char *path, int dimX, int dimY, int numWires,
+                 int order){
+  trace_header_t header;
+  memset(t, 0, sizeof(route_trace_t));
+  t->file = fopen(path, "wb");
+  if (t->file == NULL) return -1;
+  memcpy(header.magic, TRACE_MAGIC, sizeof(header.magic));
+  header.dimX = dimX;
+  header.dimY = dimY;
+  header.numWires = numWires;
+  header.order = order;
+  if (fwrite(&header, sizeof(header), 1, t->file) != 1){
+    trace_close(t);
+    return -1;
+  }
+  t->numWires = numWires;
+  t->words = (uint32_t *)malloc(numWires * sizeof(uint32_t));
+  t->swept = (char *)calloc(numWires, sizeof(char));
+  return 0;
+}
+
+int trace_replay(route_trace_t *t, const char *path, int dimX, int dimY, int numWires,
+                 int order){
+  trace_header_t header;
+  memset(t, 0, sizeof(route_trace_t));
+  t->file = fopen(path, "rb");
+  if (t->file == NULL) return -1;
+  if (fread(&header, sizeof(header), 1, t->file) != 1 ||
+      memcmp(header.magic, TRACE_MAGIC, sizeof(header.magic)) != 0 ||
+      header.dimX != dimX || header.dimY != dimY || header.numWires != numWires ||
+      header.order != order || fseek(t->file, 0, SEEK_END) != 0){
+    trace_close(t);
+    return -1;
+  }
+  // a whole number of steps, at least the initial routes
+  const long bytes = ftell(t->file) - (long)sizeof(header);
+  const long stepBytes = (long)numWires * sizeof(uint32_t);
+  if (stepBytes <= 0 || bytes < stepBytes || bytes % stepBytes != 0){
+    trace_close(t);
+    return -1;
+  }
+  fseek(t->file, sizeof(header), SEEK_SET);
+  t->numWires = numWires;
+  t->steps = (int)(bytes / stepBytes);
+  t->words = (uint32_t *)malloc(numWires * sizeof(uint32_t));
+  return 0;
+}
+
+void trace_close(route_trace_t *t){
+  if (t->file != NULL) fclose(t->file);
+  free(t->words);
+  free(t->swept);
+  memset(t, 0, sizeof(route_trace_t));
+}
+
+int trace_write(route_trace_t *t, const wire_t *wires){
+  #pragma omp parallel for default(shared) schedule(static)
+  for (int w = 0; w < t->numWires; w++){
+    t->words[w] = encodeRoute(wires[w].currentPath) | (t->swept[w] ? TRACE_SWEPT : 0);
+    t->swept[w] = 0;
+  }
+  if (t->file == NULL) return -1;
+  if (fwrite(t->words, sizeof(uint32_t), t->numWires, t->file) != (size_t)t->numWires ||
+      fflush(t->file) != 0){
+    // keep the steps written so far replayable, and write no more
+    const off_t whole = sizeof(trace_header_t) + (off_t)t->steps * t->numWires * sizeof(uint32_t);
+    if (ftruncate(fileno(t->file), whole) != 0)
+      printf("Unable to cut the trace back to %d steps.\n", t->steps);
+    fclose(t->file);
+    t->file = NULL;
+    return -1;
+  }
+  t->steps++;
+  return 0;
+}
+
+int runReplay(cost_t *costs, wire_t *wires, int numWires, route_trace_t *t){
+  double layoutTime = 0, statTime = 0, evalTime = 0;
+  long long sweeps = 0, differ = 0;
+  int s;
+  for (s = 0; s < t->steps; s++){
+    if (fread(t->words, sizeof(uint32_t), numWires, t->file) != (size_t)numWires) break;
+    if (s > 0){
+      double start = omp_get_wtime();
+      clearBoard(costs);
+      layoutBoard(costs, wires, numWires);
+      double laid = omp_get_wtime();
+      updateBoard(costs);
+      double counted = omp_get_wtime();
+      // the recorded sweeps again, against the board they saw
+      #pragma omp parallel for default(shared) reduction(+:sweeps, differ) \
+        schedule(runtime)
+      for (int w = 0; w < numWires; w++){
+        const path_t *cur = wires[w].currentPath;
+        if (!(t->words[w] & TRACE_SWEPT) || cur->bounds[0] == cur->bounds[2] ||
+            cur->bounds[1] == cur->bounds[3]) continue;
+        path_t next;
+        sweep_ctl_t ctl;
+        memcpy(&next, cur, sizeof(path_t));
+        memset(&ctl, 0, sizeof(ctl));
+        value_t best = calculatePath(costs, cur->bounds[0], cur->bounds[1], cur->bounds[2],
+                                     cur->bounds[3], cur->numBends, cur->bends[0],
+                                     cur->bends[1], cur->bends[2], cur->bends[3], -1);
+        sweepRoutes(costs, cur, w, &best, &next, &ctl);
+        sweeps++;
+        if (encodeRoute(&next) != (t->words[w] & ~TRACE_SWEPT)) differ++;
+      } /* implicit barrier */
+      layoutTime += laid - start;
+      statTime += counted - laid;
+      evalTime += omp_get_wtime() - counted;
+      printf("Replay step %d: max %d, aggregated cost %d\n", s, costs->currentMax,
+             costs->currentAggrTotal);
+    }
+    #pragma omp parallel for default(shared) schedule(static)
+    for (int w = 0; w < numWires; w++){
+      memcpy(wires[w].prevPath, wires[w].currentPath, sizeof(path_t));
+      decodeRoute(t->words[w], wires[w].currentPath);
+    }
+  }
+  printf("Replay: %d steps, layout %lf s, statistics %lf s, evaluation %lf s\n", s,
+         layoutTime, statTime, evalTime);
+  printf("Replay: %lld sweeps, %lld picked another route than recorded\n", sweeps, differ);
+  return s;
+}
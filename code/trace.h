@@ -0,0 +1,62 @@
+/**
+ * Parallel VLSI Wire Routing via OpenMP
+ * Jack Kasbeer (jkasbeer), Qifang Cai (qcai)
+ *
+ * Record and replay of routing decisions: a record run writes every
+ * iteration's route per wire to a binary trace, and a replay drives the
+ * layout, statistics and evaluation phases from it, so kernels and board
+ * layouts can be timed on exactly the same work.
+ */
+
+#ifndef __TRACE_H__
+#define __TRACE_H__
+
+#include "wireroute.h"
+
+#define TRACE_MAGIC "WRT1"
+
+/* trace_header_t *
+ * Start of a trace file.  numWires route words (native byte order) per
+ * step follow: step 0 holds the initial routes, step s the routes picked
+ * in the s-th annealing iteration.
+ */
+typedef struct
+{
+  char magic[4];
+  int32_t dimX;
+  int32_t dimY;
+  int32_t numWires;
+  int32_t order;    // ORDER_* the wires were numbered in (wireorder.h)
+} trace_header_t;
+
+/* A route word: bits 0-1 numBends, bit 2 set if the route starts
+ * vertically, bit 3 set if a sweep picked it, bits 4-31 the bend column
+ * (or row) of a two bend route.  The bounds give the rest. */
+#define TRACE_VERTICAL 0x4u
+#define TRACE_SWEPT    0x8u
+#define TRACE_COORD_SHIFT 4
+
+/* Create 'path' for recording; returns 0 on success */
+int trace_record(route_trace_t *t, const char *path, int dimX, int dimY, int numWires,
+                 int order);
+/* Open 'path' for replay; it must have been recorded for the same board,
+ * wires and order, and hold one or more whole steps.  Returns 0 on success */
+int trace_replay(route_trace_t *t, const char *path, int dimX, int dimY, int numWires,
+                 int order);
+void trace_close(route_trace_t *t);
+/* Append the wires' current routes as the next step.  Returns 0 on
+ * success; on failure the file is cut back to the steps before and closed,
+ * and every later call fails too */
+int trace_write(route_trace_t *t, const wire_t *wires);
+
+/* runReplay *
+ * Set the routes of step 0, then for every later step: lay the current
+ * routes out, take the board's statistics, sweep again every wire the
+ * trace says was swept (counting where the sweep now disagrees), and move
+ * every wire to its recorded route.  Prints the time of each phase.  On
+ * return 'wires' hold the last step's routes (the board is stale).
+ * Returns the number of steps replayed.
+ */
+int runReplay(cost_t *costs, wire_t *wires, int numWires, route_trace_t *t);
+
+#endif /* __TRACE_H__ */
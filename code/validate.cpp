@@ -0,0 +1,246 @@
+/**
+ * Parallel VLSI Wire Routing via OpenMP
+ * Jack Kasbeer (jkasbeer), Qifang Cai (qcai)
+ *
+ * Native route validator: rebuilds the cost array from an output_* route
+ * file and checks it against the matching costs_* file, like validate.py.
+ */
+
+#include "options.h"
+#include "textfile.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <climits>
+#include <omp.h>
+
+#define MAX_POINTS 4 // start, at most two bends, end
+
+static void show_help(const char *program_path)
+{
+    printf("Usage: %s OPTIONS\n", program_path);
+    printf("\n");
+    printf("OPTIONS:\n");
+    printf("\t-r <route_filename> (required)\n");
+    printf("\t-c <cost_filename> (required)\n");
+    printf("\t-f <input_filename> (check the end points too)\n");
+    printf("\t-n <num_of_threads>\n");
+}
+
+/* checkWire *
+ * Parse one route line and, if it is legal, add it to 'cost' (when not
+ * NULL).  Returns NULL or what is wrong with it.
+ */
+static const char *checkWire(const char *line, const char *end, int dimX, int dimY,
+                             const long long *bounds, int *cost){
+  long long pts[2*MAX_POINTS + 1];
+  int n = 0;
+  long long v;
+  while (next_int(&line, end, &v)){
+    if (n == 2*MAX_POINTS) return "more than two bends";
+    pts[n++] = v;
+  }
+  if (line != end) return "not a number";
+  if (n % 2 != 0) return "end points don't come in pairs";
+  if (n < 4) return "fewer than two points";
+  for (int p = 0; p < n; p += 2){
+    if (pts[p] < 0 || pts[p] >= dimX || pts[p+1] < 0 || pts[p+1] >= dimY)
+      return "point outside the grid";
+    if (p + 2 < n && pts[p] != pts[p+2] && pts[p+1] != pts[p+3])
+      return "segment is not horizontal or vertical";
+  }
+  if (bounds != NULL){
+    int fwd = pts[0] == bounds[0] && pts[1] == bounds[1] &&
+              pts[n-2] == bounds[2] && pts[n-1] == bounds[3];
+    int rev = pts[0] == bounds[2] && pts[1] == bounds[3] &&
+              pts[n-2] == bounds[0] && pts[n-1] == bounds[1];
+    if (!fwd && !rev) return "end points differ from the input";
+  }
+  if (cost == NULL) return NULL;
+  // every segment covers [from, to), the last point is counted once
+  for (int p = 0; p + 2 < n; p += 2){
+    int x = (int)pts[p], y = (int)pts[p+1];
+    int dx = pts[p+2] > x ? 1 : (pts[p+2] < x ? -1 : 0);
+    int dy = pts[p+3] > y ? 1 : (pts[p+3] < y ? -1 : 0);
+    while (x != pts[p+2] || y != pts[p+3]){
+      #pragma omp atomic
+      cost[(size_t)y*dimX + x] += 1;
+      x += dx;
+      y += dy;
+    }
+  }
+  #pragma omp atomic
+  cost[(size_t)pts[n-1]*dimX + pts[n-2]] += 1;
+  return NULL;
+}
+
+// read "a b" (or "a") from the start of a line
+static int headerInts(const mapped_file_t *f, const size_t *starts, long line,
+                      int count, long long *out){
+  const char *p = f->data + starts[line];
+  const char *end = f->data + starts[line + 1];
+  for (int i = 0; i < count; i++)
+    if (!next_int(&p, end, &out[i])) return 0;
+  return 1;
+}
+
+int main(int argc, const char *argv[])
+{
+  init_options(argc, argv);
+  const char *route_filename = get_option_string("-r", NULL);
+  const char *cost_filename = get_option_string("-c", NULL);
+  const char *input_filename = get_option_string("-f", NULL);
+  int num_of_threads = get_option_int("-n", omp_get_max_threads());
+
+  if (route_filename == NULL || cost_filename == NULL){
+    show_help(argv[0]);
+    return 1;
+  }
+  omp_set_num_threads(num_of_threads);
+
+  mapped_file_t route, cost, input;
+  size_t *routeLines, *costLines, *inputLines = NULL;
+  long numRouteLines, numCostLines, numInputLines = 0;
+  long long hdr[2];
+  if (map_file(&route, route_filename)){
+    printf("Unable to open file: %s.\n", route_filename);
+    return 1;
+  }
+  if (map_file(&cost, cost_filename)){
+    printf("Unable to open file: %s.\n", cost_filename);
+    return 1;
+  }
+  numRouteLines = split_lines(&route, &routeLines);
+  numCostLines = split_lines(&cost, &costLines);
+
+  /* Route header */
+  if (numRouteLines < 2 || !headerInts(&route, routeLines, 0, 2, hdr)){
+    printf("Route: missing dimensions.\n");
+    return 1;
+  }
+  int dimX = (int)hdr[0], dimY = (int)hdr[1];
+  if (!headerInts(&route, routeLines, 1, 1, hdr)){
+    printf("Route: missing number of wires.\n");
+    return 1;
+  }
+  long numWires = (long)hdr[0];
+  printf("rows(%d), cols(%d), wires(%ld)\n", dimY, dimX, numWires);
+  if (numRouteLines != numWires + 2){
+    printf("Route: Expected # of wires %ld, Actual # of wires %ld\n", numWires, numRouteLines - 2);
+    return 1;
+  }
+
+  /* Optional input file for the end points */
+  if (input_filename != NULL){
+    if (map_file(&input, input_filename)){
+      printf("Unable to open file: %s.\n", input_filename);
+      return 1;
+    }
+    numInputLines = split_lines(&input, &inputLines);
+    if (numInputLines < numWires + 2){
+      printf("Input: fewer wires than the route file.\n");
+      return 1;
+    }
+  }
+
+  /* Rebuild the cost array, one wire per iteration */
+  int *expected = (int *)calloc((size_t)dimX * dimY, sizeof(int));
+  long badWire = LONG_MAX;
+  #pragma omp parallel for default(shared) reduction(min:badWire) schedule(dynamic, 64)
+  for (long w = 0; w < numWires; w++){
+    long long bounds[4];
+    const long long *b = NULL;
+    if (inputLines != NULL){
+      const char *p = input.data + inputLines[w + 2];
+      const char *end = input.data + inputLines[w + 3];
+      for (int i = 0; i < 4; i++) if (!next_int(&p, end, &bounds[i])) bounds[i] = -1;
+      b = bounds;
+    }
+    if (checkWire(route.data + routeLines[w + 2], route.data + routeLines[w + 3],
+                  dimX, dimY, b, expected) != NULL && w < badWire)
+      badWire = w;
+  }
+  if (badWire != LONG_MAX){
+    // run the bad one again to say what is wrong with it
+    long long bounds[4];
+    const long long *b = NULL;
+    if (inputLines != NULL){
+      const char *p = input.data + inputLines[badWire + 2];
+      const char *end = input.data + inputLines[badWire + 3];
+      for (int i = 0; i < 4; i++) if (!next_int(&p, end, &bounds[i])) bounds[i] = -1;
+      b = bounds;
+    }
+    printf("Route: wire %ld (line %ld): %s\n", badWire, badWire + 3,
+           checkWire(route.data + routeLines[badWire + 2], route.data + routeLines[badWire + 3],
+                     dimX, dimY, b, NULL));
+    printf("Validation failed.\n");
+    return 1;
+  }
+  printf("Cost Array constructed\n");
+
+  /* Compare against the cost file, one row per iteration */
+  if (numCostLines < 1 || !headerInts(&cost, costLines, 0, 2, hdr) ||
+      hdr[0] != dimX || hdr[1] != dimY){
+    printf("Cost Array: dimension mismatch.\n");
+    printf("Validation failed.\n");
+    return 1;
+  }
+  if (numCostLines != dimY + 1){
+    printf("Cost Array: Incorrect # of rows.\n");
+    printf("Validation failed.\n");
+    return 1;
+  }
+  long badCell = LONG_MAX;
+  int badCols = 0;
+  int maxVal = 0;
+  long long aggr = 0;
+  #pragma omp parallel for default(shared) schedule(static) \
+    reduction(min:badCell) reduction(max:maxVal, badCols) reduction(+:aggr)
+  for (int row = 0; row < dimY; row++){
+    const char *p = cost.data + costLines[row + 1];
+    const char *end = cost.data + costLines[row + 2];
+    long long v;
+    int col = 0;
+    while (next_int(&p, end, &v)){
+      if (col < dimX){
+        if (v != expected[(size_t)row*dimX + col] && (long)row*dimX + col < badCell)
+          badCell = (long)row*dimX + col;
+        if (v > maxVal) maxVal = (int)v;
+        if (v > 1) aggr += v;
+      }
+      col++;
+    }
+    if (col != dimX) badCols = 1;
+  }
+  if (badCols){
+    printf("Cost Array: Incorrect # of cols.\n");
+    printf("Validation failed.\n");
+    return 1;
+  }
+  if (badCell != LONG_MAX){
+    printf("Cost Array: Value mismatch at (%ld, %ld)\n", badCell / dimX, badCell % dimX);
+    printf("Validation failed.\n");
+    return 1;
+  }
+
+  // name the result like wireroute does: file name without directory,
+  // "output_" prefix or extension
+  const char *name = strrchr(route_filename, '/');
+  char base[1024];
+  name = (name != NULL) ? name + 1 : route_filename;
+  if (strncmp(name, "output_", 7) == 0) name += 7;
+  snprintf(base, sizeof(base), "%s", name);
+  if (strchr(base, '.') != NULL) *strchr(base, '.') = '\0';
+  printf("Input File: %s has total aggregated cost: [%lld] and max layers: [%d]\n",
+         base, aggr, maxVal);
+  printf("Validate succeeded.\n");
+
+  free(expected);
+  free(routeLines);
+  free(costLines);
+  free(inputLines);
+  unmap_file(&route);
+  unmap_file(&cost);
+  if (input_filename != NULL) unmap_file(&input);
+  return 0;
+}
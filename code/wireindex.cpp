@@ -0,0 +1,183 @@
+/**
+ * Parallel VLSI Wire Routing via OpenMP
+ * Jack Kasbeer (jkasbeer), Qifang Cai (qcai)
+ */
+
+#include "wireindex.h"
+#include "routekernel.h"
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <omp.h>
+
+void index_init(wire_index_t *idx, const cost_t *costs, int numWires){
+  memset(idx, 0, sizeof(wire_index_t));
+  idx->flag = (char *)calloc(numWires, sizeof(char));
+}
+
+void index_free(wire_index_t *idx){
+  free(idx->cells);
+  free(idx->offset);
+  free(idx->cursor);
+  free(idx->wires);
+  free(idx->flag);
+  delete[] idx->hits;
+  delete[] idx->fresh;
+  delete[] idx->picked;
+  memset(idx, 0, sizeof(wire_index_t));
+}
+
+/* index_layout *
+ * Pass 1: lay every wire out as layoutWire does; a thread that takes a
+ *         cell to 2 notes the cell and both wires in it, and every later
+ *         crossing of a congested cell is noted by the thread making it.
+ * Pass 2: the noted cells are numbered thread by thread, and an exclusive
+ *         scan of their values (= their crossings) gives each its range.
+ * Pass 3: every thread drops its noted crossings into those ranges.
+ */
+void index_layout(wire_index_t *idx, cost_t *costs, wire_t *wires, int numWires){
+  const int nthreads = omp_get_max_threads();
+  if (nthreads > idx->threads){
+    delete[] idx->hits;
+    delete[] idx->fresh;
+    delete[] idx->picked;
+    idx->threads = nthreads;
+    idx->hits = new std::vector<index_hit_t>[nthreads];
+    idx->fresh = new std::vector<cost_cell_t *>[nthreads];
+    idx->picked = new std::vector<int>[nthreads];
+  }
+  for (int t = 0; t < idx->threads; t++){
+    idx->hits[t].clear();
+    idx->fresh[t].clear();
+  }
+  int maxVal = 0;
+
+  clearBoard(costs);
+  #pragma omp parallel default(shared) reduction(max:maxVal)
+  {
+    std::vector<index_hit_t> &hits = idx->hits[omp_get_thread_num()];
+    std::vector<cost_cell_t *> &fresh = idx->fresh[omp_get_thread_num()];
+    #pragma omp for schedule(runtime)
+    for (int w = 0; w < numWires; w++){
+      walkPath(wires[w].currentPath, [&](int x, int y){
+        cost_cell_t *c = writeCell(costs, x, y);
+        int val, first = -1;
+        omp_set_lock(&c->lock);
+          val = c->val + 1;
+          storeVal(c, x, y, val);
+          if (c->wire < WIRE_MAX){
+            c->list[c->wire] = w;
+            c->wire += 1;
+          }
+          if (val == 2) first = c->list[0];
+        omp_unset_lock(&c->lock);
+        if (val > maxVal) maxVal = val;
+        if (val < 2) return;
+        if (val == 2){
+          index_hit_t h = {c, first};
+          fresh.push_back(c);
+          hits.push_back(h);
+        }
+        index_hit_t h = {c, w};
+        hits.push_back(h);
+      });
+    }
+  }
+  idx->maxVal = maxVal;
+
+  size_t n = 0;
+  std::vector<size_t> base(idx->threads + 1);
+  for (int t = 0; t < idx->threads; t++){
+    base[t] = n;
+    n += idx->fresh[t].size();
+  }
+  idx->numCells = n;
+  if (n > idx->cellCapacity){
+    free(idx->cells);
+    free(idx->cursor);
+    idx->cellCapacity = n + n / 4;
+    idx->cells = (cost_cell_t **)malloc(idx->cellCapacity * sizeof(cost_cell_t *));
+    idx->cursor = (size_t *)malloc(idx->cellCapacity * sizeof(size_t));
+  }
+  // offset[n] is written even when no cell is congested
+  if (idx->offset == NULL || n + 1 > idx->offsetCapacity){
+    free(idx->offset);
+    idx->offsetCapacity = n + 1 + n / 4;
+    idx->offset = (size_t *)malloc(idx->offsetCapacity * sizeof(size_t));
+  }
+  #pragma omp parallel for default(shared) schedule(static, 1)
+  for (int t = 0; t < idx->threads; t++){
+    for (size_t k = 0; k < idx->fresh[t].size(); k++){
+      idx->fresh[t][k]->slot = (int)(base[t] + k);
+      idx->cells[base[t] + k] = idx->fresh[t][k];
+    }
+  }
+
+  std::vector<size_t> blockSum(nthreads + 1);
+  #pragma omp parallel default(shared)
+  {
+    int t = omp_get_thread_num();
+    int nt = omp_get_num_threads();
+    size_t lo = n * t / nt;
+    size_t hi = n * (t + 1) / nt;
+    size_t sum = 0;
+    for (size_t s = lo; s < hi; s++) sum += idx->cells[s]->val;
+    blockSum[t + 1] = sum;
+    #pragma omp barrier
+    #pragma omp single
+    for (int b = 1; b <= nt; b++) blockSum[b] += blockSum[b - 1];
+    /* implicit barrier */
+    sum = blockSum[t];
+    for (size_t s = lo; s < hi; s++){
+      idx->offset[s] = sum;
+      idx->cursor[s] = sum;
+      sum += idx->cells[s]->val;
+    }
+    if (t == nt - 1) idx->offset[n] = sum;
+  }
+  if (n == 0) idx->offset[0] = 0;
+
+  if (idx->offset[n] > idx->capacity){
+    free(idx->wires);
+    idx->capacity = idx->offset[n] + idx->offset[n] / 4;
+    idx->wires = (int *)malloc(idx->capacity * sizeof(int));
+  }
+
+  #pragma omp parallel for default(shared) schedule(static, 1)
+  for (int t = 0; t < idx->threads; t++){
+    for (const index_hit_t &h : idx->hits[t]){
+      size_t pos;
+      #pragma omp atomic capture
+      pos = idx->cursor[h.cell->slot]++;
+      idx->wires[pos] = h.wire;
+    }
+  }
+}
+
+int index_select(wire_index_t *idx, int threshold, int slack, int *out){
+  const size_t n = idx->numCells;
+  int hot = idx->maxVal - slack;
+  int count = 0;
+  if (threshold < hot) hot = threshold;
+  if (hot < 2) hot = 2; // cells of cost 0 or 1 are never congested
+
+  for (int t = 0; t < idx->threads; t++) idx->picked[t].clear();
+  #pragma omp parallel default(shared)
+  {
+    std::vector<int> &picked = idx->picked[omp_get_thread_num()];
+    #pragma omp for schedule(dynamic, 64)
+    for (size_t s = 0; s < n; s++){
+      if (idx->cells[s]->val < hot) continue;
+      for (size_t k = idx->offset[s]; k < idx->offset[s + 1]; k++){
+        int w = idx->wires[k];
+        if (!__atomic_exchange_n(&idx->flag[w], 1, __ATOMIC_RELAXED)) picked.push_back(w);
+      }
+    }
+  }
+  for (int t = 0; t < idx->threads; t++){
+    for (int w : idx->picked[t]) out[count++] = w;
+  }
+  std::sort(out, out + count);
+  for (int k = 0; k < count; k++) idx->flag[out[k]] = 0;
+  return count;
+}
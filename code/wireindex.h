@@ -0,0 +1,60 @@
+/**
+ * Parallel VLSI Wire Routing via OpenMP
+ * Jack Kasbeer (jkasbeer), Qifang Cai (qcai)
+ *
+ * Cell-to-wire occupancy index (CSR) of the congested cells, produced
+ * while the board is laid out, and congestion-driven wire selection.
+ */
+
+#ifndef __WIREINDEX_H__
+#define __WIREINDEX_H__
+
+#include <vector>
+#include "wireroute.h"
+
+/* index_hit_t *
+ * Wire 'wire' crossing congested cell 'cell', as seen by the layout
+ */
+typedef struct
+{
+  cost_cell_t *cell;
+  int wire;
+} index_hit_t;
+
+/* wire_index_t *
+ * Only cells the layout took to a value of 2 or more are indexed: they are
+ * numbered 0 .. numCells-1 (cost_cell_t::slot) in the order the layout
+ * threads reached them, and the wires through cell s are
+ * wires[offset[s] .. offset[s+1]).  Unlike the per-cell list in
+ * cost_cell_t this is not capped at WIRE_MAX.  Building and selecting
+ * cost time in the congested cells' wire crossings, not in the board or
+ * the wire count.
+ */
+typedef struct
+{
+  size_t numCells;     // congested cells of the last layout
+  size_t cellCapacity; // allocated length of cells and cursor
+  size_t offsetCapacity; // allocated length of offset (>= numCells + 1)
+  int maxVal;          // largest cell value of the last layout
+  cost_cell_t **cells; // per slot: its cell
+  size_t *offset;      // numCells + 1 entries
+  size_t *cursor;      // fill position per slot (scratch for the build)
+  int *wires;          // offset[numCells] entries
+  size_t capacity;     // allocated length of wires
+  char *flag;          // per wire: scratch for index_select (all 0 between calls)
+  int threads;         // per thread buffers below
+  std::vector<index_hit_t> *hits;    // crossings of congested cells
+  std::vector<cost_cell_t *> *fresh; // cells this thread took to 2
+  std::vector<int> *picked;          // index_select's wires
+} wire_index_t;
+
+void index_init(wire_index_t *idx, const cost_t *costs, int numWires);
+void index_free(wire_index_t *idx);
+/* Clear the board and lay the wires' paths out on it, indexing every
+ * congested cell on the way (replaces clearBoard + layoutBoard) */
+void index_layout(wire_index_t *idx, cost_t *costs, wire_t *wires, int numWires);
+/* Collect (in wire order) every wire crossing a cell with value > 1 that is
+ * >= threshold or >= maxVal - slack.  Returns how many went into 'out' */
+int index_select(wire_index_t *idx, int threshold, int slack, int *out);
+
+#endif /* __WIREINDEX_H__ */
@@ -0,0 +1,86 @@
+/**
+ * Parallel VLSI Wire Routing via OpenMP
+ * Jack Kasbeer (jkasbeer), Qifang Cai (qcai)
+ */
+
+#include "wireorder.h"
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <vector>
+#include <omp.h>
+
+// bits x and y interleaved, x in the even ones
+static inline unsigned long long mortonKey(unsigned int x, unsigned int y){
+  unsigned long long key = 0;
+  for (int b = 0; b < 32; b++){
+    key |= (unsigned long long)((x >> b) & 1) << (2*b);
+    key |= (unsigned long long)((y >> b) & 1) << (2*b + 1);
+  }
+  return key;
+}
+
+// distance of (x, y) along the Hilbert curve filling a side x side square
+static inline unsigned long long hilbertKey(unsigned int side, unsigned int x, unsigned int y){
+  unsigned long long key = 0;
+  for (unsigned int s = side / 2; s > 0; s /= 2){
+    unsigned int rx = (x & s) > 0;
+    unsigned int ry = (y & s) > 0;
+    key += (unsigned long long)s * s * ((3 * rx) ^ ry);
+    if (ry == 0){ // rotate the quadrant
+      if (rx == 1){
+        x = side - 1 - x;
+        y = side - 1 - y;
+      }
+      unsigned int t = x;
+      x = y;
+      y = t;
+    }
+  }
+  return key;
+}
+
+int *order_wires(wire_t *wires, int numWires, int dimX, int dimY, int curve){
+  if (curve == ORDER_FILE) return NULL;
+  unsigned int side = 1;
+  while (side < (unsigned int)dimX || side < (unsigned int)dimY) side *= 2;
+  std::vector<std::pair<unsigned long long, int> > keys(numWires);
+  #pragma omp parallel for default(shared) schedule(static)
+  for (int w = 0; w < numWires; w++){
+    const int *b = wires[w].currentPath->bounds;
+    unsigned int cx = (unsigned int)(b[0] + b[2]) / 2, cy = (unsigned int)(b[1] + b[3]) / 2;
+    if (curve == ORDER_ROWS){
+      unsigned int top = (unsigned int)(b[1] < b[3] ? b[1] : b[3]) >> BOARD_TILE_SHIFT;
+      keys[w].first = (unsigned long long)top << 32 | cx;
+    }
+    else keys[w].first = curve == ORDER_HILBERT ? hilbertKey(side, cx, cy) : mortonKey(cx, cy);
+    keys[w].second = w;
+  }
+  std::sort(keys.begin(), keys.end()); // the index breaks ties
+
+  int *perm = (int *)malloc(numWires * sizeof(int));
+  path_t *tmp = (path_t *)malloc(numWires * sizeof(path_t));
+  #pragma omp parallel for default(shared) schedule(static)
+  for (int w = 0; w < numWires; w++)
+    memcpy(&tmp[w], wires[w].currentPath, sizeof(path_t));
+  #pragma omp parallel for default(shared) schedule(static)
+  for (int k = 0; k < numWires; k++){
+    perm[k] = keys[k].second;
+    memcpy(wires[k].currentPath, &tmp[perm[k]], sizeof(path_t));
+  }
+  free(tmp);
+  return perm;
+}
+
+void order_restore(wire_t *wires, int numWires, int *perm){
+  if (perm == NULL) return;
+  path_t *tmp = (path_t *)malloc(numWires * sizeof(path_t));
+  #pragma omp parallel for default(shared) schedule(static)
+  for (int k = 0; k < numWires; k++)
+    memcpy(&tmp[perm[k]], wires[k].currentPath, sizeof(path_t));
+  #pragma omp parallel for default(shared) schedule(static)
+  for (int w = 0; w < numWires; w++)
+    memcpy(wires[w].currentPath, &tmp[w], sizeof(path_t));
+  free(tmp);
+  free(perm);
+}
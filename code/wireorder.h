@@ -0,0 +1,30 @@
+/**
+ * Parallel VLSI Wire Routing via OpenMP
+ * Jack Kasbeer (jkasbeer), Qifang Cai (qcai)
+ *
+ * Spatially coherent wire order: renumber wires along a space-filling curve
+ * so neighbouring wire numbers (and so one thread's chunk) route through
+ * neighbouring parts of the board.
+ */
+
+#ifndef __WIREORDER_H__
+#define __WIREORDER_H__
+
+#include "wireroute.h"
+
+/* Curves to order by */
+#define ORDER_FILE    0 // as read
+#define ORDER_MORTON  1 // Z-order of the bounding box center
+#define ORDER_HILBERT 2 // Hilbert order of the bounding box center
+#define ORDER_ROWS    3 // board tile row of the bounding box top, then center x
+
+/* order_wires *
+ * Sort the wires' routes in place by the 'curve' key of their bounding
+ * box centers (ties keep file order).  Returns perm, perm[k] = the file
+ * position of the wire now numbered k (NULL for ORDER_FILE).
+ */
+int *order_wires(wire_t *wires, int numWires, int dimX, int dimY, int curve);
+/* Put the routes back in file order and free perm (NULL: nothing to do) */
+void order_restore(wire_t *wires, int numWires, int *perm);
+
+#endif /* __WIREORDER_H__ */
@@ -4,56 +4,72 @@
  */
 
 #include "wireroute.h"
+#include "routekernel.h"
+#include "boardmem.h"
+#include "wireindex.h"
+#include "dirtymap.h"
+#include "seglayout.h"
+#include "multilevel.h"
+#include "portfolio.h"
+#include "circuitfile.h"
+#include "pyramid.h"
+#include "autotune.h"
+#include "anytime.h"
+#include "wireorder.h"
+#include "eco.h"
+#include "greedy.h"
+#include "outofcore.h"
+#include "textfile.h"
+#include "trace.h"
 #include <chrono>
 #include <unistd.h>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <climits>
 #include <assert.h>
 #include <omp.h>
 #include "mic.h"
 
-static int _argc;
-static const char **_argv;
-
-/////////////////////////////////////
-// COMMAND LINE FUNCTIONS
-////////////////////////////////////
-
-const char *get_option_string(const char *option_name,
-			      const char *default_value)
-{
-  for (int i = _argc - 2; i >= 0; i -= 2)
-    if (strcmp(_argv[i], option_name) == 0)
-      return _argv[i + 1];
-  return default_value;
-}
-
-int get_option_int(const char *option_name, int default_value)
-{
-  for (int i = _argc - 2; i >= 0; i -= 2)
-    if (strcmp(_argv[i], option_name) == 0)
-      return atoi(_argv[i + 1]);
-  return default_value;
-}
-
-float get_option_float(const char *option_name, float default_value)
-{
-  for (int i = _argc - 2; i >= 0; i -= 2)
-    if (strcmp(_argv[i], option_name) == 0)
-      return (float)atof(_argv[i + 1]);
-  return default_value;
-}
-
 static void show_help(const char *program_path)
 {
     printf("Usage: %s OPTIONS\n", program_path);
     printf("\n");
     printf("OPTIONS:\n");
     printf("\t-f <input_filename> (required)\n");
+    printf("\t-eco <route_filename> (start from these routes, -f only names the outputs)\n");
+    printf("\t-delta <edits_filename> (-eco: wire edits to apply, see eco.h)\n");
     printf("\t-n <num_of_threads> (required)\n");
     printf("\t-p <SA_prob>\n");
     printf("\t-i <SA_iters>\n");
+    printf("\t-deadline <seconds> (iterate until then instead, write the best routes seen)\n");
+    printf("\t-b <batch_size> (commit reroutes every batch_size wires)\n");
+    printf("\t-async <0|1> (commit every reroute immediately)\n");
+    printf("\t-sel <0|1> (reroute only wires through congested cells)\n");
+    printf("\t-thr <cost> (-sel: a cell of this cost is congested)\n");
+    printf("\t-slack <n> (-sel: so is any cell within n of the max)\n");
+    printf("\t-k <chains> (portfolio: split threads into independent chains)\n");
+    printf("\t-x <iters> (portfolio: iterations between replica exchanges)\n");
+    printf("\t-seed <seed> (portfolio: base seed of the chains)\n");
+    printf("\t-pyramid <tile> (also write a tiled cost pyramid, tile x tile cells)\n");
+    printf("\t-pin <0|1> (bind thread t to cpu t)\n");
+    printf("\t-huge <0|1> (back board and wires with huge pages)\n");
+    printf("\t-sparse <0|1> (allocate board tiles only where wires go)\n");
+    printf("\t-order <file|morton|hilbert|rows> (route wires in this order, output stays in file order)\n");
+    printf("\t-ooc <dir> (out of core: board and wires in scratch files in dir, wires in waves)\n");
+    printf("\t-ooc_mem <MB> (-ooc: board rows one wave may touch)\n");
+    printf("\t-memo <0|1> (reuse a wire's last sweep if nothing near it moved)\n");
+    printf("\t-binned <0|1> (lay out by row band owner, no cell locks)\n");
+    printf("\t-greedy <batch> (initial routes longest first against the board, batch wires at a time)\n");
+    printf("\t-coarse <cells> (route on cells x cells blocks first, then refine)\n");
+    printf("\t-citers <iters> (-coarse: iterations on the coarse board)\n");
+    printf("\t-budget <n> (sweep at most n bend positions per wire, last iteration all)\n");
+    printf("\t-sample <strided|random|congest> (-budget: how the bends are picked)\n");
+    printf("\t-tune <0|1> (pick threads, chunk size and board representation by a calibration run)\n");
+    printf("\t-tune_iters <iters> (-tune: iterations timed per candidate)\n");
+    printf("\t-tunecache <file> (-tune: results per input signature)\n");
+    printf("\t-record <file> (write every iteration's routes to a binary trace)\n");
+    printf("\t-replay <file> (lay out, count and sweep a recorded trace's routes instead)\n");
 }
 
 /////////////////////////////////////
@@ -81,6 +97,109 @@ void init_wires(FILE *input, wire_t *batch, int numWires)
   }
 }
 
+// lines starting in [lo, hi) (a newline at the last byte starts none)
+static long countLines(const char *data, size_t size, size_t lo, size_t hi){
+  long count = 0;
+  for (size_t p = lo; p < hi; p++)
+    if (p == 0 || data[p - 1] == '\n') count++;
+  return count;
+}
+
+/* read_wires *
+ * Fill wires and their paths from a mapped input file (the records after
+ * a circuit_header_t, or lines 2 on of a text file) while the threads
+ * first touch the tiles of a reserved dense board, by the static tile rows
+ * allocBoard uses.  One thread cuts the file into blocks and hands them
+ * out as tasks (counting every block's lines first for a text file); the
+ * others pick the blocks up as soon as their own rows are done.
+ * Returns how many wires the file holds (only the first numWires are
+ * read), or -1 once it has said which line does not hold a wire.
+ */
+static long read_wires(const mapped_file_t *input, int binary, wire_t *wires, path_t *paths,
+                       int numWires, cost_t *costs, region_t *boardMem){
+  const char *data = input->data;
+  const size_t size = input->size;
+  const size_t recBytes = 4 * sizeof(int32_t);
+  const size_t first = binary ? sizeof(circuit_header_t) : 0;
+  const size_t blockBytes = (size_t)1 << 20; // a whole number of records
+  const long numBlocks = size > first ? (long)((size - first + blockBytes - 1) / blockBytes) : 0;
+  long *before = (long *)calloc(numBlocks + 1, sizeof(long)); // lines before each block
+  long *bad = (long *)malloc((numBlocks + 1) * sizeof(long));  // first bad line per block
+
+  #pragma omp parallel default(shared)
+  {
+    #pragma omp single nowait
+    {
+      if (!binary){
+        for (long b = 0; b < numBlocks; b++){
+          #pragma omp task default(shared) firstprivate(b)
+          before[b + 1] = countLines(data, size, b * blockBytes,
+                                     std::min(size, (b + 1) * blockBytes));
+        }
+        #pragma omp taskwait
+        for (long b = 0; b < numBlocks; b++) before[b + 1] += before[b];
+      }
+      for (long b = 0; b < numBlocks; b++){
+        #pragma omp task default(shared) firstprivate(b)
+        {
+          const size_t lo = first + b * blockBytes;
+          const size_t hi = std::min(size, lo + blockBytes);
+          long line = before[b];
+          bad[b] = LONG_MAX;
+          for (size_t p = lo; p < hi; p++){
+            long long pt[4];
+            long i;
+            if (binary){
+              if (p + recBytes > size) break;
+              int32_t rec[4];
+              memcpy(rec, data + p, recBytes);
+              for (int k = 0; k < 4; k++) pt[k] = rec[k];
+              i = (long)((p - first) / recBytes);
+              p += recBytes - 1;
+            }
+            else{
+              if (p != 0 && data[p - 1] != '\n') continue;
+              i = line++ - 2;
+              if (i < 0 || i >= numWires) continue;
+              const char *q = data + p;
+              const char *end = (const char *)memchr(q, '\n', size - p);
+              int k = 0;
+              while (k < 4 && next_int(&q, end != NULL ? end : data + size, &pt[k])) k++;
+              if (k < 4){
+                bad[b] = i + 2;
+                break;
+              }
+            }
+            if (i >= numWires) continue;
+            wires[i].currentPath = &paths[2*i];
+            wires[i].prevPath = &paths[2*i + 1];
+            wires[i].currentPath->numBends = 0;
+            for (int k = 0; k < 4; k++) wires[i].currentPath->bounds[k] = (int)pt[k];
+          }
+        }
+      }
+    }
+    if (!costs->sparse){
+      #pragma omp for schedule(static) nowait
+      for (int ty = 0; ty < costs->tilesY; ty++)
+        touchBoard(costs, boardMem, ty);
+    }
+  } /* implicit barrier: every block is read */
+
+  long held = binary ? (long)((size - first) / recBytes) : before[numBlocks] - 2;
+  if (held < 0) held = 0;
+  for (long b = 0; b < numBlocks; b++){
+    if (bad[b] != LONG_MAX){
+      printf("Line %ld is not a wire.\n", bad[b] + 1);
+      held = -1;
+      break;
+    }
+  }
+  free(before);
+  free(bad);
+  return held;
+}
+
 /* init_cost_array *
  * Clean up main routine, init cost array here
  */
@@ -99,16 +218,21 @@ void init_cost_array(cost_t *arr, int numWires, int cols, int rows)
   }
 }
 */
+// rand() unless the caller owns a seed (seeded chains are reproducible)
+static inline int nextRand(unsigned int *seed){
+  return seed != NULL ? rand_r(seed) : rand();
+}
+
 /* new_rand_path *
  * Generate a random path in the space of delta_x + delta_y
  * 50% change pick x traversal  50% chance pick y traversal
  * random generate bends
  */
-void new_rand_path(wire_t *wire){
+void new_rand_path(wire_t *wire, unsigned int *seed){
   //overwrite previous path
-  srand(time(NULL));
+  if (seed == NULL) srand(time(NULL));
   int bend = 0;
-  std::memcpy(wire->prevPath, wire->currentPath, sizeof(wire_t));
+  std::memcpy(wire->prevPath, wire->currentPath, sizeof(path_t));
   int s_x, s_y, e_x, e_y, dy, yp, dx, xp;
   s_x = wire->currentPath->bounds[0];
   s_y = wire->currentPath->bounds[1];
@@ -123,9 +247,9 @@ void new_rand_path(wire_t *wire){
   dy = abs(e_y - s_y);
   dx = abs(e_x - s_x);
   // calculate random point on y axis
-  if ((rand() % 10)> 5){
+  if ((nextRand(seed) % 10)> 5){
     // y first
-    int ran_y = rand() % dy;
+    int ran_y = nextRand(seed) % dy;
     if (ran_y == 0) ran_y = 1; // need to make progress
     if(s_y > e_y)  yp = s_y - ran_y;
     else yp = s_y + ran_y;
@@ -140,7 +264,7 @@ void new_rand_path(wire_t *wire){
   }
   else{
     // x first traversal
-    int ran_x = rand() % dx;
+    int ran_x = nextRand(seed) % dx;
     if (ran_x == 0) ran_x = 1;
     if(s_x > e_x)  xp = s_x - ran_x;
     else xp = s_x + ran_x;
@@ -157,16 +281,17 @@ void new_rand_path(wire_t *wire){
 
 /* horizontal_cost *
  * Update cost array for horizontal traversal
- * Input: ptr to board, y coord, starting x, ending x, dim_y
+ * Input: ptr to board, y coord, starting x, ending x, +1/-1
  */
-void horizontalCost(cost_cell_t *C, int row, int startX, int endX, int dimY, int wire_n){
+void horizontalCost(cost_t *costs, int row, int startX, int endX, int wire_n, int delta){
   int s_x = startX;
   // Determine path direction
   int dir = startX > endX ? -1 : 1;
   /* Update cost array for given wire */
   while (s_x != endX){
     /*### UPDATING CELL: CRITICAL REGION ###*/
-      incrCell(C, s_x, row, dimY, wire_n);
+      if (delta > 0) incrCell(costs, s_x, row, wire_n);
+      else decrCell(costs, s_x, row, wire_n);
     /*######################################*/
     s_x += dir; // add/subtract a column
   }
@@ -174,46 +299,203 @@ void horizontalCost(cost_cell_t *C, int row, int startX, int endX, int dimY, int
 
 /* vertical_cost *
  * Update cost array for vertical traversal
- * Input: ptr to board, x coord, starting y, ending y, dim_y
+ * Input: ptr to board, x coord, starting y, ending y, +1/-1
  */
-void verticalCost(cost_cell_t *C, int xCoord, int startY, int endY, int dimY, int wire_n){
+void verticalCost(cost_t *costs, int xCoord, int startY, int endY, int wire_n, int delta){
   int s_y = startY;
   // Determine path direction
   int dir = startY > endY ? -1 : 1;
   /* Update cost array for given wire */
   while (s_y != endY){
     /*### UPDATING CELL: CRITICAL REGION ###*/
-      incrCell(C, xCoord, s_y, dimY, wire_n);
+      if (delta > 0) incrCell(costs, xCoord, s_y, wire_n);
+      else decrCell(costs, xCoord, s_y, wire_n);
     /*######################################*/
     s_y += dir;
   }
 }
 
+/* newTile *
+ * Give a sparse board's directory entry its own tile.  Whoever loses the
+ * race to install one frees theirs and uses the winner's.
+ */
+cost_cell_t *newTile(cost_t *costs, cost_cell_t **entry){
+  cost_cell_t *tile = (cost_cell_t *)calloc(1, BOARD_TILE_BYTES);
+  cost_cell_t *expected = costs->zero;
+  for (int c = 0; c < BOARD_TILE_CELLS; c++) omp_init_lock(&tile[c].lock);
+  if (__atomic_compare_exchange_n(entry, &expected, tile, false,
+                                  __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)){
+    __atomic_fetch_add(&costs->usedTiles, 1, __ATOMIC_RELAXED);
+    return tile;
+  }
+  for (int c = 0; c < BOARD_TILE_CELLS; c++) omp_destroy_lock(&tile[c].lock);
+  free(tile);
+  return expected;
+}
+
 // Use cell level lock to safely incre value by 1
-// INPUT: ptr to board, x coord , y coord, dim_y
-void incrCell(cost_cell_t *C, int x, int y, int dimY, int wire_n){
+// INPUT: ptr to board, x coord , y coord
+void incrCell(cost_t *costs, int x, int y, int wire_n){
   cost_cell_t *c;
-  c = &C[y*dimY + x]; // calculate the idx in board
+  c = writeCell(costs, x, y); // find (or make) the cell's tile
   omp_set_lock(&c->lock);
-    c->val +=1;
+    storeVal(c, x, y, c->val + 1);
     if(c->wire < WIRE_MAX){
-      c->list[c->wire] = wire_n;
-      c->wire += 1;
+      __atomic_store_n(&c->list[c->wire], wire_n, __ATOMIC_RELAXED);
+      __atomic_store_n(&c->wire, c->wire + 1, __ATOMIC_RELAXED);
+    }
+  omp_unset_lock(&c->lock);
+}
+
+// Use cell level lock to safely decr value by 1 and drop wire_n from the list
+// INPUT: ptr to board, x coord , y coord
+void decrCell(cost_t *costs, int x, int y, int wire_n){
+  cost_cell_t *c;
+  c = writeCell(costs, x, y); // a laid out cell's tile always exists
+  omp_set_lock(&c->lock);
+    storeVal(c, x, y, c->val - 1);
+    for (int count = 0; count < c->wire; count++){
+      if(c->list[count] == wire_n){
+        __atomic_store_n(&c->wire, c->wire - 1, __ATOMIC_RELAXED);
+        __atomic_store_n(&c->list[count], c->list[c->wire], __ATOMIC_RELAXED);
+        break;
+      }
     }
   omp_unset_lock(&c->lock);
 }
 
+/* layoutWire *
+ * Add (delta = 1) or rip up (delta = -1) a path on the board
+ */
+void layoutWire(cost_t *costs, const path_t *mypath, int wire_n, int delta){
+  int s_x = mypath->bounds[0];   // (start point)
+  int s_y = mypath->bounds[1];
+  int e_x = mypath->bounds[2];   // (end point)
+  int e_y = mypath->bounds[3];
+  int b1_x = mypath->bends[0];   // bend coordinates (if any)
+  int b1_y = mypath->bends[1];
+  int b2_x = mypath->bends[2];
+  int b2_y = mypath->bends[3];
+  // Follow path & update cost array
+  switch (mypath->numBends) {
+    case 0:
+      if (s_y == e_y){ // Horizontal path
+        horizontalCost(costs, s_y, s_x, e_x, wire_n, delta);
+        break;
+      }
+      verticalCost(costs, e_x, s_y, e_y, wire_n, delta); // Vertical path
+      break;
+    case 1:
+      if (s_y == b1_y) // Before bend is horizontal
+      {
+        horizontalCost(costs, s_y, s_x, b1_x, wire_n, delta);
+        // After bend must be vertical
+        verticalCost(costs, e_x, b1_y, e_y, wire_n, delta);
+        break;
+      }
+      verticalCost(costs, s_x, s_y, b1_y, wire_n, delta); // Before bend is vertical
+      // After bend must be horizontal
+      horizontalCost(costs, e_y, b1_x, e_x, wire_n, delta);
+      break;
+    default:
+      if (s_y == b1_y) // Before bend is horizontal
+      {
+        horizontalCost(costs, s_y, s_x, b1_x, wire_n, delta);
+        verticalCost(costs, b1_x, b1_y, b2_y, wire_n, delta);//after bend is vertical
+        horizontalCost(costs, e_y, b2_x, e_x, wire_n, delta);
+        break;
+      }
+      verticalCost(costs, s_x, s_y, b1_y, wire_n, delta); // Before bend is vertical
+      horizontalCost(costs, b1_y, b1_x, b2_x, wire_n, delta);//after bend is horizontal
+      verticalCost(costs, b2_x, b2_y, e_y, wire_n, delta);
+      break;
+  }
+  if (delta > 0) incrCell(costs, e_x, e_y, wire_n);
+  else decrCell(costs, e_x, e_y, wire_n);
+}
+
+/* commitWire *
+ * Move a rerouted wire on the board: rip up prevPath, lay down currentPath
+ */
+void commitWire(cost_t *costs, wire_t *wire, int wire_n){
+  if (std::memcmp(wire->prevPath, wire->currentPath, sizeof(path_t)) == 0)
+    return; // kept its route
+  layoutWire(costs, wire->prevPath, wire_n, -1);
+  layoutWire(costs, wire->currentPath, wire_n, 1);
+}
+
+/* rerouteWire *
+ * One annealing step for one wire: with probability 1 - P pick the cheapest
+ * route against the board, otherwise a random one.  The old route is left
+ * in prevPath.  With a memo, a sweep from the route a still valid memo
+ * started from is not repeated, and every sweep done is remembered.  A
+ * corridor limits the bends the sweep tries, and so does a budget.  ctl
+ * may be NULL (a full sweep, no memo).
+ */
+void rerouteWire(cost_t *costs, wire_t *wire, int wire_n, double SA_prob, unsigned int *seed,
+                 sweep_ctl_t *ctl){
+  path_t *mypath = wire->currentPath;
+  path_t next;
+  value_t localMax;
+  int s_x, s_y, e_x, e_y;
+  sweep_ctl_t full;
+  if (ctl == NULL){
+    std::memset(&full, 0, sizeof(full));
+    ctl = &full;
+  }
+  route_memo_t *memo = ctl->memo;
+  ctl->swept = 0;
+  // With probability 1 - P, choose the current min path.
+  if (seed == NULL) srand(time(NULL));
+  if((nextRand(seed)%100) > int(SA_prob*100)){ // xx% chance pick the complicated  algo
+    s_x = mypath->bounds[0];   // (start point)
+    s_y = mypath->bounds[1];
+    e_x = mypath->bounds[2];   // (end point)
+    e_y = mypath->bounds[3];
+    std::memcpy(&next, mypath, sizeof(path_t));
+    ctl->swept = 1;
+    if (memo != NULL && memo->valid &&
+        std::memcmp(&memo->from, mypath, sizeof(path_t)) == 0){
+      std::memcpy(&next, &memo->to, sizeof(path_t)); // same board, same answer
+    }
+    else if ( s_x != e_x && s_y != e_y){
+      localMax = calculatePath(costs, s_x, s_y, e_x, e_y, mypath->numBends,
+              mypath->bends[0], mypath->bends[1], mypath->bends[2], mypath->bends[3], -1);
+      // L routes, then every bend column, then every bend row
+      if (ctl->budget > 0) ctl->salt = nextRand(seed);
+      sweepRoutes(costs, mypath, wire_n, &localMax, &next, ctl);
+      if (memo != NULL){
+        std::memcpy(&memo->from, mypath, sizeof(path_t));
+        std::memcpy(&memo->to, &next, sizeof(path_t));
+        memo->valid = 1;
+      }
+    }
+    // set new wire
+    std::memcpy(wire->prevPath, mypath, sizeof(path_t));
+    std::memcpy(mypath, &next, sizeof(path_t));
+  }
+  else{ // xx% chance take random path
+    new_rand_path(wire, seed);
+    if (memo != NULL) memo->valid = 0; // the board may move under it unseen
+  }
+}
+
 /* use to run board statistic  */
 void updateBoard(cost_t *board){
   // overwrite the previous data
   board->prevMax = board->currentMax;
   board->prevAggrTotal = board->currentAggrTotal;
+  const size_t numTiles = (size_t)board->tilesX * board->tilesY;
   int Max = 0;
   int Total = 0;
-  // traversal to count the board
-  for (int row = 0; row < board->dimY; row++){
-    for (int col = 0;  col < board->dimX; col++){
-      int val = board->board[row* board->dimY + col].val;
+  // traversal to count the board (cells past the edge of a tile stay 0)
+  #pragma omp parallel for default(shared) reduction(max:Max) reduction(+:Total) \
+    schedule(static)
+  for (size_t t = 0; t < numTiles; t++){
+    const cost_cell_t *tile = board->tiles[t];
+    if (tile == board->zero) continue;
+    for (int c = 0; c < BOARD_TILE_CELLS; c++){
+      int val = tile[c].val;
       if(val > Max) Max = val;
       if(val > 1) Total += val;
     }
@@ -222,47 +504,271 @@ void updateBoard(cost_t *board){
   board->currentAggrTotal = Total;
 }
 
-// read a value in the board
-inline int readBoard(cost_t *board, int x, int y, int wire_n){
-  cost_cell_t *c;
-  c = &board->board[y*board->dimY + x];
-  for (int count = 0; count < c->wire; count++){
-    if(wire_n == c->list[count])
-      return c->val-1;
+/* allocBoard *
+ * Make the tile directory of a dimX x dimY board.  A dense board maps all
+ * its tiles at once and first touches them (plus their cell level locks)
+ * by the same static tile rows clearBoard uses, so each band's pages land
+ * on the node of the thread that keeps touching them.  A sparse one only
+ * gets the shared zero tile; incrCell adds the rest as wires arrive.
+ */
+int allocBoard(cost_t *costs, region_t *mem, int dimX, int dimY, int huge, int sparse){
+  if (reserveBoard(costs, mem, dimX, dimY, huge, sparse))
+    return -1;
+  if (!sparse){
+    #pragma omp parallel for default(shared) schedule(static)
+    for (int ty = 0; ty < costs->tilesY; ty++)
+      touchBoard(costs, mem, ty);
   }
-  return c->val;
+  return 0;
 }
 
-// get vertical cell values
-value_t readVertical(cost_t* board, int x, int s_y, int e_y, int wire_n){
-  value_t result;
-  result.aggr_max = 0;
-  result.m = 0;
-  int dir = s_y > e_y ? -1:1;
-  int c = s_y;
-  while(c != e_y){
-    int val = readBoard(board,x,c, wire_n);
-    if(result.m < val) result.m = val;
-    if(val > 1) result.aggr_max += val;
-    c += dir;
-  }
-  return result;
+/* reserveBoard *
+ * allocBoard, short of first touching a dense board's tiles
+ */
+int reserveBoard(cost_t *costs, region_t *mem, int dimX, int dimY, int huge, int sparse){
+  memset(costs, 0, sizeof(cost_t));
+  memset(mem, 0, sizeof(region_t));
+  costs->dimX = dimX;
+  costs->dimY = dimY;
+  costs->tilesX = (dimX + BOARD_TILE - 1) >> BOARD_TILE_SHIFT;
+  costs->tilesY = (dimY + BOARD_TILE - 1) >> BOARD_TILE_SHIFT;
+  costs->sparse = sparse;
+  const size_t numTiles = (size_t)costs->tilesX * costs->tilesY;
+  costs->tiles = (cost_cell_t **)malloc(numTiles * sizeof(cost_cell_t *));
+  if (costs->tiles == NULL)
+    return -1;
+  if (sparse){
+    costs->zero = (cost_cell_t *)calloc(1, BOARD_TILE_BYTES);
+    if (costs->zero == NULL){
+      free(costs->tiles);
+      return -1;
+    }
+    #pragma omp parallel for default(shared) schedule(static)
+    for (size_t t = 0; t < numTiles; t++)
+      costs->tiles[t] = costs->zero;
+    return 0;
+  }
+  if (region_alloc(mem, numTiles * BOARD_TILE_BYTES, huge)){
+    free(costs->tiles);
+    return -1;
+  }
+  costs->usedTiles = numTiles;
+  return 0;
+}
+
+// first touch tile row ty of a reserved dense board (cells and locks)
+void touchBoard(cost_t *costs, region_t *mem, int ty){
+  for (int tx = 0; tx < costs->tilesX; tx++){
+    size_t t = (size_t)ty * costs->tilesX + tx;
+    cost_cell_t *tile = (cost_cell_t *)((char *)mem->ptr + t * BOARD_TILE_BYTES);
+    costs->tiles[t] = tile;
+    clearTile(tile);
+    for (int c = 0; c < BOARD_TILE_CELLS; c++)
+      omp_init_lock(&tile[c].lock);
+  }
+}
+
+void freeBoard(cost_t *costs, region_t *mem){
+  const size_t numTiles = (size_t)costs->tilesX * costs->tilesY;
+  for (size_t t = 0; t < numTiles; t++){
+    cost_cell_t *tile = costs->tiles[t];
+    if (tile == costs->zero) continue;
+    for (int c = 0; c < BOARD_TILE_CELLS; c++)
+      omp_destroy_lock(&tile[c].lock);
+    if (costs->sparse) free(tile);
+  }
+  region_free(mem);
+  free(costs->tiles);
+  free(costs->zero);
+  costs->tiles = NULL;
+  costs->zero = NULL;
 }
 
-// get horizontal cell values
-value_t readHorizontal(cost_t* board, int y, int s_x, int e_x, int wire_n){
-  value_t result;
-  result.aggr_max = 0;
-  result.m = 0;
-  int dir = s_x > e_x ? -1:1;
-  int c = s_x;
-  while(c != e_x){
-    int val = readBoard(board,c,y, wire_n);
-    if(result.m < val) result.m = val;
-    if(val > 1) result.aggr_max += val;
-    c += dir;
-  }
-  return result;
+// Clean up the board (a sparse board keeps its tiles for the next layout)
+void clearBoard(cost_t *costs){
+  const int tilesX = costs->tilesX, tilesY = costs->tilesY;
+  #pragma omp parallel for default(shared) schedule(static)
+  for (int ty = 0; ty < tilesY; ty++){
+    for (int tx = 0; tx < tilesX; tx++){
+      cost_cell_t *tile = costs->tiles[(size_t)ty * tilesX + tx];
+      if (tile != costs->zero) clearTile(tile);
+    }
+  }
+}
+
+// lay every wire's current path onto a clean board
+void layoutBoard(cost_t *costs, wire_t *wires, int numWires){
+  #pragma omp parallel for default(shared) shared(wires, costs) schedule(runtime)
+  for (int j = 0; j < numWires; j++){
+    layoutWire(costs, wires[j].currentPath, j, 1);
+  } /* implicit barrier */
+}
+
+// per (chain seed, iteration, wire) stream, independent of thread timing
+static inline unsigned int wireSeed(unsigned int seed, int iter, int wire_n){
+  unsigned int s = seed ^ ((unsigned int)iter * 2654435761u);
+  return s + (unsigned int)wire_n * 40503u + 1;
+}
+
+/* rerouteOne *
+ * rerouteWire for wire w in iteration i with the seed, corridor and budget
+ * the options give it; adds the candidates it tried (and a full sweep
+ * would have) to *tried and *total
+ */
+static inline void rerouteOne(cost_t *costs, wire_t *wires, int w, const anneal_opts_t *opts,
+                              int i, route_memo_t *memo, long long *tried, long long *total){
+  unsigned int ws = wireSeed(opts->seed, i, w);
+  sweep_ctl_t ctl;
+  ctl.memo = memo;
+  ctl.win = opts->corridor != NULL ? &opts->corridor[w] : NULL;
+  ctl.budget = i == opts->fullIter ? 0 : opts->budget;
+  ctl.sampling = opts->sampling;
+  ctl.salt = 0;
+  ctl.tried = ctl.total = 0;
+  rerouteWire(costs, &wires[w], w, opts->SA_prob, opts->seeded ? &ws : NULL, &ctl);
+  if (opts->trace != NULL) opts->trace->swept[w] = (char)ctl.swept;
+  if (opts->moved != NULL &&
+      std::memcmp(wires[w].prevPath, wires[w].currentPath, sizeof(path_t)) != 0)
+    opts->moved[w] = 1;
+  *tried += ctl.tried;
+  *total += ctl.total;
+}
+
+/* anneal *
+ * Run iterations [firstIter, lastIter) of simulated annealing on one
+ * board.  Each iteration lays the current routes out on a clean board,
+ * then reroutes wires against it; opts picks which wires and when their
+ * new routes are committed.  On return the board is stale (the routes
+ * moved after the last layout).
+ */
+void anneal(cost_t *costs, wire_t *wires, int numWires, const anneal_opts_t *opts,
+            int firstIter, int lastIter){
+  // PRIVATE variables
+  int i, w, k;
+  // SHARED variables
+  // candidate routes swept (and in full sweeps) and time spent rerouting
+  long long tried = 0, total = 0;
+  double rerouteTime = 0;
+  // wires rerouted this iteration (all of them unless selective)
+  int *active = (int *)malloc(numWires * sizeof(int));
+  int numActive = numWires;
+  wire_index_t index;
+  // memos only hold while the board stays as laid out during the reroutes
+  const int memo = opts->memo && !opts->async && opts->batchSize <= 0;
+  dirty_map_t dirty;
+  seg_bins_t bins;
+  // with async commits the board stays exact, so an ECO lays it out once
+  const int layoutOnce = opts->focus != NULL && opts->async;
+  // waves need every wire rerouted, in wire order
+  const wave_plan_t *waves = opts->selective || opts->focus != NULL ? NULL : opts->waves;
+  char *mark = opts->focus != NULL ? (char *)calloc(numWires, sizeof(char)) : NULL;
+  for (w = 0; w < numWires; w++) active[w] = w;
+  if (opts->binned) bins_init(&bins, costs);
+  if (opts->selective) index_init(&index, costs, numWires);
+  if (memo) dirty_init(&dirty, costs, numWires);
+
+  /*@@@@@@@@@@@@@@ MAIN LOOP @@@@@@@@@@@@@@*/
+  for (i = firstIter; i < lastIter; i++){
+    if (!layoutOnce || i == firstIter){
+      if (opts->selective && opts->focus == NULL) index_layout(&index, costs, wires, numWires);
+      else if (opts->binned) layoutBinned(costs, wires, numWires, &bins);
+      else waves_relayout(waves, costs, wires, numWires);
+    }
+    /* Pick the wires worth rerouting */
+    if (opts->focus != NULL){
+      numActive = eco_select(costs, wires, numWires, opts->focus, mark, active);
+      if (opts->verbose)
+        printf("Iteration %d: rerouting %d of %d wires around the edits\n", i,
+               numActive, numWires);
+    }
+    else if (opts->selective){
+      numActive = index_select(&index, opts->threshold, opts->slack, active);
+      if (opts->verbose)
+        printf("Iteration %d: max %d, rerouting %d of %d wires\n", i, index.maxVal,
+               numActive, numWires);
+    }
+    /* Parallel by wire, determine NEW path */
+    double rerouteStart = omp_get_wtime();
+    if (opts->async){
+      // every wire commits as soon as it has picked, no barrier
+      #pragma omp parallel for default(shared) reduction(+:tried, total) \
+        private(k, w) shared(wires, costs, active) schedule(runtime)
+      for (k = 0; k < numActive; k++){
+        w = active[k];
+        rerouteOne(costs, wires, w, opts, i, NULL, &tried, &total);
+        commitWire(costs, &wires[w], w);
+      }
+    }
+    else if (opts->batchSize > 0){
+      // Gauss-Seidel: each batch sees the routes committed before it
+      for (int first = 0; first < numActive; first += opts->batchSize){
+        int last = first + opts->batchSize < numActive ? first + opts->batchSize : numActive;
+        #pragma omp parallel for default(shared) reduction(+:tried, total) \
+          private(k, w) shared(wires, costs, active) schedule(runtime)
+        for (k = first; k < last; k++){
+          w = active[k];
+          rerouteOne(costs, wires, w, opts, i, NULL, &tried, &total);
+        } /* implicit barrier */
+        #pragma omp parallel for default(shared) \
+          private(k, w) shared(wires, costs, active) schedule(runtime)
+        for (k = first; k < last; k++){
+          w = active[k];
+          commitWire(costs, &wires[w], w);
+        } /* implicit barrier */
+      }
+    }
+    else if (memo){
+      // Jacobi, skipping sweeps whose bounding box is as it was last time
+      dirty_settle(&dirty, wires, numWires);
+      int moved = 0, valid = 0;
+      #pragma omp parallel for default(shared) reduction(+:moved, valid, tried, total) \
+        private(k, w) shared(wires, costs, active) schedule(runtime)
+      for (k = 0; k < numActive; k++){
+        w = active[k];
+        valid += dirty.memo[w].valid;
+        rerouteOne(costs, wires, w, opts, i, &dirty.memo[w], &tried, &total);
+        moved += dirty_moved(&dirty, &wires[w]);
+      } /* implicit barrier */
+      if (opts->verbose)
+        printf("Iteration %d: %d of %d memos valid, %d wires moved\n", i, valid,
+               numActive, moved);
+    }
+    else if (waves != NULL){
+      // Jacobi, one wave of board rows at a time while the next is read in
+      for (int v = 0; v < waves->numWaves; v++){
+        waves_prefetch(waves, v + 1);
+        #pragma omp parallel for default(shared) reduction(+:tried, total) \
+          private(w) shared(wires, costs) schedule(runtime)
+        for (w = waves->first[v]; w < waves->first[v + 1]; w++){
+          rerouteOne(costs, wires, w, opts, i, NULL, &tried, &total);
+        } /* implicit barrier */
+        waves_release(waves, v);
+      }
+    }
+    else{
+      // Jacobi: every wire picks against the board laid out above
+      #pragma omp parallel for default(shared) reduction(+:tried, total) \
+        private(k, w) shared(wires, costs, active) schedule(runtime)
+      for (k = 0; k < numActive; k++){
+        w = active[k];
+        rerouteOne(costs, wires, w, opts, i, NULL, &tried, &total);
+      } /* implicit barrier */
+    }
+    rerouteTime += omp_get_wtime() - rerouteStart;
+    // Finish picking the new path
+    if (opts->trace != NULL && opts->trace->file != NULL && trace_write(opts->trace, wires))
+      printf("Unable to write trace step %d: the trace ends at step %d.\n", i + 1,
+             opts->trace->steps - 1);
+  } /*  end iterations*/
+  if (opts->verbose && opts->budget > 0 && total > 0)
+    printf("Sweep budget %d: %lld of %lld candidates (%.1f%%), %.2f M candidates/s\n",
+           opts->budget, tried, total, 100.0 * tried / total,
+           rerouteTime > 0 ? tried / rerouteTime * 1e-6 : 0.0);
+  if (opts->selective) index_free(&index);
+  if (memo) dirty_free(&dirty);
+  if (opts->binned) bins_free(&bins);
+  free(mark);
+  free(active);
 }
 
 // combine to value_t into one
@@ -276,71 +782,37 @@ value_t combineValue( value_t v1, value_t v2){
 /////// board cost calculation
 value_t calculatePath(cost_t* board, int s_x, int s_y, int e_x, int e_y,
           int numBends, int b1_x, int b1_y, int b2_x, int b2_y, int wire_n){
-  value_t result, temp, temp1, temp2;
-  int tmp_val = readBoard(board, e_x, e_y, wire_n);
-  result.aggr_max = 0;
-  result.m = 0;
-  // Follow path & update cost array
+  // Map the stored path onto its route shape
   switch (numBends) {
     case 0:
-      if (s_y == e_y){ // Horizontal path
-        temp = readHorizontal(board, s_y, s_x, e_x,wire_n);
-        if (tmp_val > 1) result.aggr_max = temp.aggr_max + tmp_val;
-        else result.aggr_max = temp.aggr_max;
-        result.m = (temp.m > tmp_val) ? temp.m : tmp_val;
-        break;
-      }
-      if (s_x == e_x){            // Vertical path
-        temp = readVertical(board, s_x, s_y, e_y,wire_n);
-        if (tmp_val > 1) result.aggr_max = temp.aggr_max + tmp_val;
-        else result.aggr_max = temp.aggr_max;
-        result.m = (temp.m > tmp_val) ? temp.m : tmp_val;
-        break;
-      }
+      return evalRouteDir<ROUTE_STRAIGHT>(board, s_x, s_y, e_x, e_y, 0, 0, wire_n);
     case 1:
       if (s_y == b1_y) // Before bend is horizontal
-      {
-        temp1 = combineValue(readHorizontal(board, s_y, s_x, b1_x,wire_n),
-            // After bend must be vertical
-            readVertical(board, e_x, b1_y, e_y,wire_n));
-        if (tmp_val > 1) result.aggr_max = temp1.aggr_max + tmp_val;
-        else result.aggr_max = temp1.aggr_max;
-        result.m = (temp1.m > tmp_val) ? temp1.m : tmp_val;
-        break;
-      }
-      if (s_x == b1_x)           // Before bend is vertical
-      {
-        temp1 = combineValue(readVertical(board, s_x, s_y, b1_y,wire_n),
-            // After bend must be horizontal
-              readHorizontal(board, e_y, b1_x, e_x,wire_n));
-        if (tmp_val > 1) result.aggr_max = temp1.aggr_max + tmp_val;
-        else result.aggr_max = temp1.aggr_max;
-        result.m = (temp1.m > tmp_val) ? temp1.m : tmp_val;
-        break;
-      }
-    case 2:
+        return evalRouteDir<ROUTE_L_HORIZ>(board, s_x, s_y, e_x, e_y, 0, 0, wire_n);
+      return evalRouteDir<ROUTE_L_VERT>(board, s_x, s_y, e_x, e_y, 0, 0, wire_n);
+    default:
       if (s_y == b1_y) // Before bend is horizontal
-      {
-        temp = combineValue(readHorizontal(board, s_y, s_x, b1_x,wire_n),
-                readVertical(board, b1_x, b1_y, b2_y,wire_n));//after bend is vertical
-        temp2 = combineValue(temp, readHorizontal(board, e_y, b2_x, e_x,wire_n));
-        if (tmp_val > 1) result.aggr_max = temp2.aggr_max + tmp_val;
-        else result.aggr_max = temp2.aggr_max;
-        result.m = (temp2.m > tmp_val) ? temp2.m : tmp_val;
-        break;
-      }
-      if (s_x == b1_x) // Before bend is vertical
-      {
-        temp = combineValue(readVertical(board, s_x, s_y, b1_y,wire_n),
-            readHorizontal(board, b1_y, b1_x, b2_x,wire_n));//after bend is horizontal
-        temp2 = combineValue(temp, readVertical(board, b2_x, b2_y, e_y,wire_n));
-        if (tmp_val > 1) result.aggr_max = temp2.aggr_max + tmp_val;
-        else result.aggr_max = temp2.aggr_max;
-        result.m = (temp2.m > tmp_val) ? temp2.m : tmp_val;
-        break;
-      }
+        return evalRouteDir<ROUTE_Z_HORIZ>(board, s_x, s_y, e_x, e_y, b1_x, 0, wire_n);
+      return evalRouteDir<ROUTE_Z_VERT>(board, s_x, s_y, e_x, e_y, 0, b1_y, wire_n);
+  }
+}
+
+/* sweepRoutes *
+ * Search every L and Z route of a bent wire; 'best' holds the cost to beat
+ * and 'next' receives the winning bends (left alone if nothing wins)
+ */
+void sweepRoutes(cost_t* board, const path_t *path, int wire_n, value_t *best, path_t *next,
+                 sweep_ctl_t *ctl){
+  int dx = path->bounds[2] - path->bounds[0];
+  int dy = path->bounds[3] - path->bounds[1];
+  if (dx > 0){
+    if (dy > 0) sweepRoutesDir<1, 1>(board, path, wire_n, best, next, ctl);
+    else sweepRoutesDir<1, -1>(board, path, wire_n, best, next, ctl);
+  }
+  else{
+    if (dy > 0) sweepRoutesDir<-1, 1>(board, path, wire_n, best, next, ctl);
+    else sweepRoutesDir<-1, -1>(board, path, wire_n, best, next, ctl);
   }
-  return result;
 }
 
 
@@ -358,13 +830,42 @@ int main(int argc, const char *argv[])
   auto init_start = Clock::now();
   double init_time = 0;
 
-  _argc = argc - 1;
-  _argv = argv + 1;
+  init_options(argc, argv);
 
   const char *input_filename = get_option_string("-f", NULL);
+  const char *eco_filename = get_option_string("-eco", NULL);
+  const char *delta_filename = get_option_string("-delta", NULL);
   int num_of_threads = get_option_int("-n", 1);
   double SA_prob = get_option_float("-p", 0.1f);
   int SA_iters = get_option_int("-i", 5);
+  double deadline = get_option_float("-deadline", 0.0f);
+  int batch_size = get_option_int("-b", 0);
+  int async = get_option_int("-async", 0);
+  int selective = get_option_int("-sel", 0);
+  int sel_threshold = get_option_int("-thr", INT_MAX);
+  int sel_slack = get_option_int("-slack", 0);
+  int chains = get_option_int("-k", 1);
+  int exchange = get_option_int("-x", 1);
+  int seed = get_option_int("-seed", (int)time(NULL));
+  int pyramid_tile = get_option_int("-pyramid", 0);
+  int pin = get_option_int("-pin", 0);
+  int huge = get_option_int("-huge", 0);
+  int sparse = get_option_int("-sparse", 0);
+  const char *order = get_option_string("-order", "file");
+  const char *ooc_dir = get_option_string("-ooc", NULL);
+  int ooc_mem = get_option_int("-ooc_mem", 1024);
+  int memo = get_option_int("-memo", 0);
+  int binned = get_option_int("-binned", 0);
+  int greedy = get_option_int("-greedy", 0);
+  int coarse = get_option_int("-coarse", 0);
+  int coarse_iters = get_option_int("-citers", SA_iters);
+  int budget = get_option_int("-budget", 0);
+  const char *sample = get_option_string("-sample", "strided");
+  int tune = get_option_int("-tune", 0);
+  int tune_iters = get_option_int("-tune_iters", 1);
+  const char *tune_cache = get_option_string("-tunecache", "wireroute.tune");
+  const char *record_filename = get_option_string("-record", NULL);
+  const char *replay_filename = get_option_string("-replay", NULL);
 
   int error = 0;
 
@@ -380,31 +881,139 @@ int main(int argc, const char *argv[])
 
   printf("Number of threads: %d\n", num_of_threads);
   printf("Probability parameter for simulated annealing: %lf.\n", SA_prob);
-  printf("Number of simulated anneling iterations: %d\n", SA_iters);
+  if (deadline > 0) printf("Deadline: %lf seconds of annealing\n", deadline);
+  else printf("Number of simulated anneling iterations: %d\n", SA_iters);
   printf("Input file: %s\n", input_filename);
+  if (chains > 1) printf("Portfolio chains: %d, exchange every %d iterations, seed %d\n",
+                         chains, exchange, seed);
+  if (replay_filename != NULL) printf("Replay: %s\n", replay_filename);
+  else if (record_filename != NULL) printf("Record: %s\n", record_filename);
+  if (async) printf("Reroute commits: asynchronous\n");
+  else if (batch_size > 0) printf("Reroute commits: every %d wires\n", batch_size);
+
+  /* Pin before anything is touched so first-touch pages stay local */
+  omp_set_num_threads(num_of_threads);
+  omp_set_schedule(omp_sched_dynamic, 1);
+  if (pin) pin_threads();
 
-  FILE *input = fopen(input_filename, "r");
+  /* Out of core: every region from here on lives in a scratch file, the
+   * board is dense (so its rows are contiguous) and wires go by tile row */
+  if (ooc_dir != NULL){
+    region_backing(ooc_dir);
+    sparse = 0;
+    order = "rows";
+    printf("Out of core: scratch files in %s, waves of %d MB\n", ooc_dir, ooc_mem);
+  }
+
+  /* An ECO starts from a routed design with its edits applied */
+  eco_t eco;
+  if (eco_filename != NULL){
+    if (eco_load(&eco, eco_filename, delta_filename)) return 1;
+    printf("ECO: %s, %d added, %d removed, %d moved\n", eco_filename, eco.added,
+           eco.removed, eco.moved);
+  }
+  /* Map the input and have the kernel read it in while the board is set up;
+   * a pipe cannot be mapped and is read as a stream once the board is */
+  mapped_file_t mapped;
+  FILE *input = NULL;
+  memset(&mapped, 0, sizeof(mapped));
+  if (eco_filename == NULL){
+    if (map_file(&mapped, input_filename) == 0 && mapped.size != 0)
+      prefetch_file(&mapped);
+    else
+      input = fopen(input_filename, "r");
+  }
 
-  if (!input) {
+  if (eco_filename == NULL && mapped.data == NULL && !input) {
     printf("Unable to open file: %s.\n", input_filename);
     return 1;
   }
 
-  /* Parse for dimensions & num wires */
+  /* Parse for dimensions & num wires (text, or gencircuit's binary format) */
   int dim_x, dim_y;
   int num_of_wires;
-  fscanf(input, "%d %d\n", &dim_x, &dim_y);
-  fscanf(input, "%d\n", &num_of_wires);
+  circuit_header_t header;
+  int binary;
+  if (mapped.data != NULL){
+    binary = mapped.size >= sizeof(header);
+    if (binary) memcpy(&header, mapped.data, sizeof(header));
+  }
+  else binary = input != NULL && fread(&header, sizeof(header), 1, input) == 1;
+  binary = binary && memcmp(header.magic, CIRCUIT_MAGIC, sizeof(header.magic)) == 0;
+  if (eco_filename != NULL){
+    dim_x = eco.dimX;
+    dim_y = eco.dimY;
+    num_of_wires = eco.numWires;
+  }
+  else if (binary){
+    dim_x = header.dimX;
+    dim_y = header.dimY;
+    num_of_wires = header.numWires;
+  }
+  else if (mapped.data != NULL){
+    const char *p = mapped.data;
+    long long hdr[3] = {0, 0, 0};
+    for (int k = 0; k < 3; k++) next_int(&p, mapped.data + mapped.size, &hdr[k]);
+    dim_x = (int)hdr[0];
+    dim_y = (int)hdr[1];
+    num_of_wires = (int)hdr[2];
+  }
+  else{
+    rewind(input);
+    fscanf(input, "%d %d\n", &dim_x, &dim_y);
+    fscanf(input, "%d\n", &num_of_wires);
+  }
 
-  /* ALLOCATE for array of wires */
-  wire_t *wires = (wire_t *)calloc(num_of_wires, sizeof(wire_t));
-  /* Read the grid dimension and wire information from file */
-  int count = 0;
-  while(count < num_of_wires){
+  /* ALLOCATE for array of wires (and one pool for all their paths) */
+  region_t wireMem, pathMem, boardMem;
+  if (region_alloc(&wireMem, num_of_wires * sizeof(wire_t), huge) ||
+      region_alloc(&pathMem, 2 * num_of_wires * sizeof(path_t), huge)){
+    printf("Unable to allocate %d wires.\n", num_of_wires);
+    return 1;
+  }
+  wire_t *wires = (wire_t *)wireMem.ptr;
+  path_t *paths = (path_t *)pathMem.ptr;
+  /* Allocate for cost array struct; its tiles are first touched while the
+   * wires are read */
+  cost_t *costs = (cost_t *)calloc(1, sizeof(cost_t));
+  if (reserveBoard(costs, &boardMem, dim_x, dim_y, huge, sparse)){
+    printf("Unable to allocate %dx%d board.\n", dim_x, dim_y);
+    return 1;
+  }
+  costs->currentMax = num_of_wires;
+
+  /* Read the wire information from file (in parallel when mapped) */
+  long count = 0;
+  if (mapped.data != NULL){
+    count = read_wires(&mapped, binary, wires, paths, num_of_wires, costs, &boardMem);
+    unmap_file(&mapped);
+    if (count < 0) return 1;
+  }
+  else if (!sparse){
+    #pragma omp parallel for default(shared) schedule(static)
+    for (int ty = 0; ty < costs->tilesY; ty++)
+      touchBoard(costs, &boardMem, ty);
+  }
+  printf("Complete allocate board\n");
+  if (eco_filename != NULL){
+    #pragma omp parallel for default(shared) schedule(static)
+    for (int w = 0; w < num_of_wires; w++){
+      wires[w].currentPath = &paths[2*w];
+      wires[w].prevPath = &paths[2*w + 1];
+      memcpy(wires[w].currentPath, &eco.routes[w], sizeof(path_t));
+    }
+    count = num_of_wires;
+  }
+  while(input != NULL && count < num_of_wires){
     int s_x, s_y, e_x, e_y;
-    fscanf(input, "%d %d %d %d\n", &s_x, &s_y, &e_x, &e_y);
-    wires[count].prevPath = (path_t*)calloc(1, sizeof(path_t));
-    wires[count].currentPath = (path_t*)calloc(1, sizeof(path_t));
+    if (binary){
+      int32_t rec[4];
+      if (fread(rec, sizeof(rec), 1, input) != 1) break;
+      s_x = rec[0]; s_y = rec[1]; e_x = rec[2]; e_y = rec[3];
+    }
+    else if (fscanf(input, "%d %d %d %d\n", &s_x, &s_y, &e_x, &e_y) != 4) break;
+    wires[count].currentPath = &paths[2*count];
+    wires[count].prevPath = &paths[2*count + 1];
     wires[count].currentPath->numBends = 0;
     wires[count].currentPath->bounds[0] = s_x;
     wires[count].currentPath->bounds[1] = s_y;
@@ -412,41 +1021,134 @@ int main(int argc, const char *argv[])
     wires[count].currentPath->bounds[3] = e_y;
     count++;
   }
-  printf("Complete read wires: %d\n", count);
-  /* Allocate for cost array struct */
-  cost_t *costs = (cost_t *)calloc(1, sizeof(cost_t));
-  costs->dimX = dim_x;
-  costs->dimY = dim_y;
-  costs->currentMax = num_of_wires;
-  costs->board = (cost_cell_t *)calloc(dim_x * dim_y, sizeof(cost_cell_t));
-
-  cost_t *ref_board = (cost_t *)calloc(num_of_wires, sizeof(cost_t));
-  for(int counter = 0; counter < num_of_wires; counter++){
-    ref_board[counter].dimX = dim_x;
-    ref_board[counter].dimY = dim_y;
-    ref_board[counter].board = (cost_cell_t *)calloc(dim_x *dim_y, sizeof(cost_cell_t));
+  if (count != num_of_wires){
+    printf("%s holds %ld wires, its header says %d.\n", input_filename, count, num_of_wires);
+    return 1;
   }
+  printf("Complete read wires: %ld\n", count);
+  /* Number the wires along a space-filling curve */
+  int curve = strcmp(order, "hilbert") == 0 ? ORDER_HILBERT :
+              strcmp(order, "morton") == 0 ? ORDER_MORTON :
+              strcmp(order, "rows") == 0 ? ORDER_ROWS : ORDER_FILE;
+  int *wireOrder = order_wires(wires, num_of_wires, dim_x, dim_y, curve);
+  if (wireOrder != NULL) printf("Wire order: %s\n", order);
+  if (eco_filename != NULL && wireOrder != NULL){
+    char *edited = (char *)malloc(num_of_wires);
+    for (int k = 0; k < num_of_wires; k++) edited[k] = eco.edited[wireOrder[k]];
+    free(eco.edited);
+    eco.edited = edited;
+  }
+  wave_plan_t waves;
+  if (ooc_dir != NULL)
+    printf("Out of core: %d waves\n", waves_plan(&waves, costs, &boardMem, wires,
+                                                 num_of_wires, (size_t)ooc_mem << 20));
 
-  printf("Complete allocate board\n");
+  printf("Complete initialize board\n");
+  if (!sparse) region_report("Board", &boardMem);
+  region_report("Wire paths", &pathMem);
+  error = 0;
 
-  /* Initialize cell level locks */
-  for( int y = 0; y < dim_y; y++){
-    for( int x = 0; x < dim_x; x++){
-      omp_init_lock(&(costs->board[y*dim_y + x].lock));
+  anneal_opts_t opts;
+  opts.SA_prob = SA_prob;
+  opts.batchSize = batch_size;
+  opts.async = async;
+  opts.selective = selective;
+  opts.threshold = sel_threshold;
+  opts.slack = sel_slack;
+  opts.seeded = 0;
+  opts.seed = (unsigned int)seed;
+  opts.memo = memo;
+  opts.binned = binned;
+  opts.corridor = NULL;
+  opts.budget = budget;
+  opts.sampling = strcmp(sample, "random") == 0 ? SAMPLE_RANDOM :
+                  strcmp(sample, "congest") == 0 ? SAMPLE_CONGESTION : SAMPLE_STRIDED;
+  opts.fullIter = deadline > 0 ? -1 : SA_iters - 1; // no known last iteration
+  opts.focus = NULL;
+  opts.waves = ooc_dir != NULL ? &waves : NULL;
+  opts.trace = NULL;
+  opts.moved = NULL;
+  if (eco_filename != NULL){
+    // one chain from the loaded routes; calibration would reroute them all
+    opts.focus = eco.edited;
+    opts.async = 1; // keeps the board exact between iterations
+    chains = 1;
+    tune = 0;
+  }
+  best_routes_t start; // greedy routes, kept unless annealing beats them
+  start.paths = NULL;
+  /* A trace follows one chain's iterations; a replay needs no routing */
+  route_trace_t trace;
+  memset(&trace, 0, sizeof(trace));
+  if (replay_filename != NULL){
+    if (trace_replay(&trace, replay_filename, dim_x, dim_y, num_of_wires, curve)){
+      printf("Unable to replay %s: no complete trace of these wires in this order.\n",
+             replay_filename);
+      return 1;
     }
+    printf("Replay: %d steps\n", trace.steps);
+    chains = 1;
+    tune = 0;
+    coarse = 0;
   }
-  printf("Complete initialize board\n");
-  error = 0;
+  else if (record_filename != NULL){
+    if (trace_record(&trace, record_filename, dim_x, dim_y, num_of_wires, curve)){
+      printf("Unable to open file: %s.\n", record_filename);
+      return 1;
+    }
+    chains = 1;
+  }
+  corridor_t *corridor = NULL;
+  if (coarse > 1 && eco_filename == NULL)
+    corridor = (corridor_t *)malloc(num_of_wires * sizeof(corridor_t));
+  opts.verbose = 1;
 
   init_time += duration_cast<dsec>(Clock::now() - init_start).count();
   printf("Initialization Time: %lf.\n", init_time);
 
+  /* Pick threads, chunk size and board representation, from the cache or a
+   * short calibration run.  Output files keep the -n name so job scripts
+   * find them. */
+  int compute_threads = num_of_threads;
+  if (tune){
+    auto tune_start = Clock::now();
+    char sig[TUNE_SIG_LEN];
+    tune_config_t cfg;
+    // out of core boards stay dense (their rows are waved through memory)
+    const int reprs = ooc_dir != NULL ? TUNE_DENSE : TUNE_DENSE | TUNE_SPARSE;
+    tune_signature(wires, num_of_wires, dim_x, dim_y, reprs, sig);
+    if (tune_lookup(tune_cache, sig, &cfg))
+      printf("Tune cache hit: %s\n", sig);
+    else{
+      #pragma omp parallel for default(shared) schedule(dynamic)
+      for (int w = 0; w < num_of_wires; w++)
+        new_rand_path(&wires[w], NULL);
+      tune_calibrate(costs, wires, num_of_wires, &opts, num_of_threads, tune_iters, reprs,
+                     huge, &cfg);
+      tune_store(tune_cache, sig, &cfg);
+    }
+    tune_apply(&cfg);
+    compute_threads = cfg.threads;
+    if (cfg.sparse != sparse){
+      // nothing is laid out yet, so the board can be made again empty
+      freeBoard(costs, &boardMem);
+      if (allocBoard(costs, &boardMem, dim_x, dim_y, huge, cfg.sparse)){
+        printf("Unable to allocate %dx%d board.\n", dim_x, dim_y);
+        return 1;
+      }
+      costs->currentMax = num_of_wires;
+      sparse = cfg.sparse;
+    }
+    printf("Tuned: threads %d chunk %d, %s board\n", cfg.threads, cfg.chunk,
+           cfg.sparse ? "sparse" : "dense");
+    printf("Tune Time: %lf.\n", duration_cast<dsec>(Clock::now() - tune_start).count());
+  }
+
   /**************************************
    **** START COMPUTATION
    **************************************/
   auto compute_start = Clock::now();
   double compute_time = 0;
-  omp_set_num_threads(num_of_threads);
 #ifdef RUN_MIC /* Use RUN_MIC to distinguish between the target of compilation */
 
   /* This pragma means we want the code in the following block be executed in
@@ -468,284 +1170,83 @@ int main(int argc, const char *argv[])
   inout(costs: length(dim_x*dim_y) INOUT)
 #endif
   {
-    // PRIVATE variables
-    int i, j, x, y, w, row, col;
-    path_t *mypath;
-    value_t localMax, tempMax;
-    int s_x, s_y, e_x, e_y;
-    int b1_x, b1_y, b2_x, b2_y;
-    int n1_x, n1_y, n2_x, n2_y;
-    int nBend, dir;
-    // SHARED variables
-    cost_cell_t *B = costs->board;
+    int w;
     /* ########## PARALLEL BY WIRE ##########*/
     /* Initialize all 'first' paths (create a start board) */
-    #pragma omp parallel for default(shared)                       \
-      private(w) shared(wires) schedule(dynamic)
-    for (w = 0; w < num_of_wires; w++){
-      new_rand_path( &(wires[w]) );
-    } /* implicit barrier */
-
-    /*@@@@@@@@@@@@@@ MAIN LOOP @@@@@@@@@@@@@@*/
-    for (i = 0; i < SA_iters; i++){
-      // Clean up the board
-      #pragma omp parallel for default(shared) \
-        private(y, x) shared(B) schedule(dynamic)
-      for( y = 0; y < dim_y; y++){
-        for( x = 0; x < dim_x; x++){
-          B[y*dim_y + x].val = 0;  // clean up board
-          B[y*dim_y + x].wire = 0;  // clean up board
-        }
-      }
-      /*  layout board */
-      #pragma omp parallel for default(shared)                            \
-        private(b1_x, b2_x, b1_y, b2_y,j,mypath,s_x,s_y,e_x,e_y)\
-          shared(wires, B) schedule(dynamic)
-      for (j = 0; j < num_of_wires; j++){
-        // Initialize wire private variables
-        mypath    = wires[j].currentPath;
-        s_x = mypath->bounds[0];   // (start point)
-        s_y = mypath->bounds[1];
-        e_x = mypath->bounds[2];   // (end point)
-        e_y = mypath->bounds[3];
-        // Follow path & update cost array
-        switch (mypath->numBends) {
-          case 0:
-            if (s_y == e_y){ // Horizontal path
-              horizontalCost(B, s_y, s_x, e_x, dim_y, j);
-              incrCell(B, e_x, e_y, dim_y, j);
-              break;
-            }
-            if (s_x == e_x){            // Vertical path
-              verticalCost(B, e_x, s_y, e_y, dim_y, j);
-              incrCell(B, e_x, e_y, dim_y, j);
-              break;
-            }
-          case 1:
-            b1_x = mypath->bends[0];
-            b1_y = mypath->bends[1]; // Get bend coordinate
-            if (s_y == b1_y) // Before bend is horizontal
-            {
-              horizontalCost(B, s_y, s_x, b1_x, dim_y,j);
-              // After bend must be vertical
-              verticalCost(B, e_x, b1_y, e_y, dim_y , j);
-              incrCell(B, e_x, e_y, dim_y, j);
-              break;
-            }
-            if (s_x == b1_x)           // Before bend is vertical
-            {
-              verticalCost(B, s_x, s_y, b1_y, dim_y, j);
-              // After bend must be horizontal
-              horizontalCost(B, e_y, b1_x, e_x, dim_y,j);
-              incrCell(B, e_x, e_y, dim_y, j);
-              break;
-            }
-          case 2:
-            b1_x = mypath->bends[0]; // Get both bend coordinates
-            b1_y = mypath->bends[1];
-            b2_x = mypath->bends[2];
-            b2_y = mypath->bends[3];
-            // Exam first bend
-            if (s_y == b1_y) // Before bend is horizontal
-            {
-              horizontalCost(B, s_y, s_x, b1_x, dim_y, j);
-              verticalCost(B, b1_x, b1_y, b2_y, dim_y, j);//after bend is vertical
-              horizontalCost(B, e_y, b2_x, e_x,dim_y, j);
-              incrCell(B, e_x, e_y, dim_y, j);
-              break;
-            }
-            if (s_x == b1_x) // Before bend is vertical
-            {
-              verticalCost(B, s_x, s_y, b1_y, dim_y, j);
-              horizontalCost(B, b1_y, b1_x, b2_x, dim_y, j);//after bend is horizontal
-              verticalCost(B, b2_x, b2_y, e_y, dim_y, j);
-              incrCell(B, e_x, e_y, dim_y, j);
-              break;
-            }
-        }
+    if (replay_filename != NULL){
+      // step 0 of the trace holds them
+    }
+    else if (eco_filename != NULL){
+      // only the edited wires need a first route
+      #pragma omp parallel for default(shared)                       \
+        private(w) shared(wires) schedule(dynamic)
+      for (w = 0; w < num_of_wires; w++){
+        if (eco.edited[w]) new_rand_path( &(wires[w]), NULL );
       } /* implicit barrier */
-      /* Save temp board for calculation
-      #pragma omp parallel for default(shared) \
-        private(w) shared(ref_board, wires, B) schedule(dynamic)
-      for( w = 0 ; w < num_of_wires; w++){
-        // copyBoard(ref_board[w].board, B, dim_x, dim_y);
-        // clean up current wire
-        //cleanUpWire(ref_board[w], wires[w].currentPath);
-      }
-      printf("finish cleanup \n");
-    */
-      /* Parallel by wire, determine NEW path */
-      #pragma omp parallel for default(shared)       \
-          private(w,row, col,  mypath, localMax, tempMax, s_x, s_y, e_x, e_y, b1_x, b2_x, \
-                  b1_y, b2_y, n1_x, n1_y, n2_x, n2_y, nBend, dir) \
-              shared(wires, costs) schedule(dynamic)
+    }
+    else if (corridor != NULL){
+      routeCoarse(costs, wires, num_of_wires, &opts, coarse, coarse_iters, corridor);
+      opts.corridor = corridor;
+    }
+    else if (greedy > 0){
+      routeGreedy(costs, wires, num_of_wires, greedy, opts.waves);
+      updateBoard(costs);
+      printf("Greedy routing: batches of %d, max %d, aggregated cost %d\n", greedy,
+             costs->currentMax, costs->currentAggrTotal);
+      best_init(&start, num_of_wires);
+      best_offer(&start, wires, costs->currentMax, costs->currentAggrTotal);
+    }
+    else{
+      #pragma omp parallel for default(shared)                       \
+        private(w) shared(wires) schedule(dynamic)
       for (w = 0; w < num_of_wires; w++){
-        // With probability 1 - P, choose the current min path.
-        srand(time(NULL));
-        if((rand()%100) > int(SA_prob*100)){ // xx% chance pick the complicated  algo
-          //printf("Running Complicated Path Generating Algo %d %d  \n", rand() %100, int(SA_prob*100));
-          mypath = wires[w].currentPath;
-          s_x = mypath->bounds[0];   // (start point)
-          s_y = mypath->bounds[1];
-          e_x = mypath->bounds[2];   // (end point)
-          e_y = mypath->bounds[3];
-          b1_x = mypath->bends[0];
-          b1_y = mypath->bends[1];
-          b2_x = mypath->bends[2];
-          b2_y = mypath->bends[3];
-          n1_x = b1_x;
-          n1_y = b1_y;
-          n2_x = b2_x;
-          n2_y = b2_y;
-          nBend = mypath->numBends;
-          if ( s_x != e_x && s_y != e_y){
-            localMax = calculatePath(costs, s_x, s_y, e_x, e_y, nBend, b1_x, b1_y, b2_x, b2_y, -1);
-            // case of one bend, at the end points
-            // -> horizontal first:
-            tempMax = calculatePath(costs, s_x, s_y, e_x, e_y, 1 ,e_x, s_y, 0, 0, w);
-            if(tempMax.m < localMax.m && tempMax.aggr_max < localMax.aggr_max){
-              localMax.m = tempMax.m;
-              localMax.aggr_max = tempMax.aggr_max;
-              nBend = 1;
-              n1_x = e_x;
-              n1_y = s_y;
-            }
-            // -> vertical one bend
-            tempMax = calculatePath(costs, s_x, s_y, e_x, e_y, 1 ,s_x, e_y, 0, 0, w);
-            if(tempMax.m < localMax.m && tempMax.aggr_max < localMax.aggr_max){
-              localMax.m = tempMax.m;
-              localMax.aggr_max = tempMax.aggr_max;
-              nBend = 1;
-              n1_x = s_x;
-              n1_y = e_y;
-            }
-            // calculate horizontal path
-            dir = (e_x > s_x) ? 1 : -1;
-            for ( col = s_x + dir; col != e_x; col += dir){
-              tempMax = calculatePath(costs, s_x, s_y, e_x, e_y,2, col, s_y, col , e_y, w);
-              if(tempMax.m < localMax.m && tempMax.aggr_max < localMax.aggr_max){
-                localMax.m = tempMax.m;
-                localMax.aggr_max = tempMax.aggr_max;
-                nBend = 2;
-                n1_x = col;
-                n1_y = s_y;
-                n2_x = col;
-                n2_y = e_y;
-              }
-            }
-            // calculate vertical path
-            dir = (e_y > s_y) ? 1 : -1;
-            for(row = s_y + dir; row != e_y; row += dir){
-              tempMax = calculatePath(costs, s_x, s_y, e_x, e_y, 2, s_x, row, e_x, row, w);
-              if(tempMax.m < localMax.m && tempMax.aggr_max < localMax.aggr_max){
-                localMax.m = tempMax.m;
-                localMax.aggr_max = tempMax.aggr_max;
-                nBend = 2;
-                n1_x = s_x;
-                n1_y = row;
-                n2_x = e_x;
-                n2_y = row;
-              }
-            }
-          }
-          // set new wire
-          std::memcpy(wires[w].prevPath, mypath, sizeof(wire_t));
-          mypath->numBends = nBend;
-          mypath->bends[0] = n1_x;
-          mypath->bends[1] = n1_y;
-          mypath->bends[2] = n2_x;
-          mypath->bends[3] = n2_y;
-        }
-        else{ // xx% chance take random path
-          new_rand_path( &(wires[w]) );
-        } /* implicit barrier */
-      }
-      // Finish picking the new path
-    } /*  end iterations*/
-
-    ////////////////////////////////////////////////////////////////////////////
-     // clean up board
-    #pragma omp parallel for default(shared) \
-      private(y, x) shared(B) schedule(dynamic)
-    for( y = 0; y < dim_y; y++){
-      for( x = 0; x < dim_x; x++){
-        B[y*dim_y + x].val = 0;
-        B[y*dim_y + x].wire = 0;  // clean up board
+        new_rand_path( &(wires[w]), NULL );
+      } /* implicit barrier */
+    }
+
+    if (record_filename != NULL && replay_filename == NULL){
+      if (trace_write(&trace, wires)){ // step 0: the initial routes
+        printf("Unable to write file: %s.\n", record_filename);
+        return 1;
       }
+      opts.trace = &trace;
     }
-    /*  layout final result board  */
-    #pragma omp parallel for default(shared)                            \
-      private(j,mypath,s_x,s_y,e_x,e_y,b1_x, b2_x, b1_y, b2_y)\
-        shared(wires, B) schedule(dynamic)
-    for (j = 0; j < num_of_wires; j++){
-      // Initialize wire private variables
-      mypath    = wires[j].currentPath;
-      s_x = mypath->bounds[0];   // (start point)
-      s_y = mypath->bounds[1];
-      e_x = mypath->bounds[2];   // (end point)
-      e_y = mypath->bounds[3];
-      // Follow path & update cost array
-      switch (mypath->numBends) {
-        case 0:
-          if (s_y == e_y){ // Horizontal path
-            horizontalCost(B, s_y, s_x, e_x, dim_y, j);
-            incrCell(B, e_x, e_y, dim_y, j);
-            break;
-          }
-          if (s_x == e_x){            // Vertical path
-            verticalCost(B, e_x, s_y, e_y, dim_y, j);
-            incrCell(B, e_x, e_y, dim_y, j);
-            break;
-          }
-        case 1:
-          b1_x = mypath->bends[0];
-          b1_y = mypath->bends[1]; // Get bend coordinate
-          if (s_y == b1_y) // Before bend is horizontal
-          {
-            horizontalCost(B, s_y, s_x, b1_x, dim_y, j);
-            // After bend must be vertical
-            verticalCost(B, e_x, b1_y, e_y, dim_y, j);
-            incrCell(B, e_x, e_y, dim_y, j);
-            break;
-          }
-          if (s_x == b1_x)           // Before bend is vertical
-          {
-            verticalCost(B, s_x, s_y, b1_y, dim_y, j);
-            // After bend must be horizontal
-            horizontalCost(B, e_y, b1_x, e_x, dim_y, j);
-            incrCell(B, e_x, e_y, dim_y, j);
-            break;
-          }
-        case 2:
-          b1_x = mypath->bends[0]; // Get both bend coordinates
-          b1_y = mypath->bends[1];
-          b2_x = mypath->bends[2];
-          b2_y = mypath->bends[3];
-          // Exam first bend
-          if (s_y == b1_y) // Before bend is horizontal
-          {
-            horizontalCost(B, s_y, s_x, b1_x, dim_y, j);
-            verticalCost(B, b1_x, b1_y, b2_y, dim_y, j);//after bend is vertical
-            horizontalCost(B, e_y, b2_x, e_x,dim_y, j);
-            incrCell(B, e_x, e_y, dim_y, j);
-            break;
-          }
-          if (s_x == b1_x) // Before bend is vertical
-          {
-            verticalCost(B, s_x, s_y, b1_y, dim_y, j);
-            horizontalCost(B, b1_y, b1_x, b2_x, dim_y, j);//after bend is horizontal
-            verticalCost(B, b2_x, b2_y, e_y, dim_y, j);
-            incrCell(B, e_x, e_y, dim_y, j);
-            break;
-          }
+    if (replay_filename != NULL)
+      runReplay(costs, wires, num_of_wires, &trace);
+    else if (chains > 1)
+      runPortfolio(costs, wires, num_of_wires, &opts, chains, compute_threads,
+                   SA_iters, exchange, huge, deadline);
+    else if (deadline > 0)
+      runAnytime(costs, wires, num_of_wires, &opts, deadline);
+    else
+      anneal(costs, wires, num_of_wires, &opts, 0, SA_iters);
+
+    /*  layout final result board (an ECO's async commits kept it current)  */
+    if (eco_filename == NULL || deadline > 0 || SA_iters < 1 || replay_filename != NULL){
+      waves_relayout(opts.waves, costs, wires, num_of_wires);
+    }
+    /*  annealing from a greedy start may only make it worse: then keep it  */
+    if (start.paths != NULL){
+      updateBoard(costs);
+      if (start.max < costs->currentMax ||
+          (start.max == costs->currentMax && start.aggr < costs->currentAggrTotal)){
+        printf("Greedy routes kept: annealing ended at max %d, aggregated cost %d\n",
+               costs->currentMax, costs->currentAggrTotal);
+        best_restore(&start, wires);
+        waves_relayout(opts.waves, costs, wires, num_of_wires);
       }
-    } /* implicit barrier */
-    ///////////////////////////////////////////////////////
+      best_free(&start);
+    }
   }
   /* #################### END PRAGMA ################### */
 
   compute_time += duration_cast<dsec>(Clock::now() - compute_start).count();
   printf("Computation Time: %lf.\n", compute_time);
+  order_restore(wires, num_of_wires, wireOrder); // write in file order
+  if (sparse)
+    printf("Board tiles: %zu of %zu allocated (%zu bytes)\n", costs->usedTiles,
+           (size_t)costs->tilesX * costs->tilesY,
+           costs->usedTiles * BOARD_TILE_BYTES);
   // update board statistic ////////////////
   updateBoard(costs);
   /////////////////////////////
@@ -799,7 +1300,7 @@ int main(int argc, const char *argv[])
   /*wrting to Cost */
   for(int row = 0 ; row < dim_y; row++){
     for(int col = 0; col < dim_x; col++){
-      fprintf(outputCost, "%d ", costs->board[row*dim_y + col].val);
+      fprintf(outputCost, "%d ", boardCell(costs, col, row)->val);
     }
     fprintf(outputCost, "\n");
   }
@@ -823,25 +1324,29 @@ int main(int argc, const char *argv[])
   }
   fclose(outputCost);
   fclose(outputWire);
-
-  /* FREE TO ALL ! */
-  for( int y = 0; y < dim_y; y++){
-    for( int x = 0; x < dim_x; x++){
-      omp_destroy_lock(&(costs->board[y*dim_y + x].lock));
+  /* Multi-resolution cost tiles, next to the costs file */
+  if (pyramid_tile > 0){
+    char pyramidFileName[1024];
+    auto pyramid_start = Clock::now();
+    snprintf(pyramidFileName, sizeof(pyramidFileName), "%.*s/pyramid_%s_%s.bin",
+             (int)(strrchr(costFileName, '/') - costFileName), costFileName, cwd, buf);
+    if (write_pyramid(pyramidFileName, costs, pyramid_tile)){
+      perror("Error opening file!\n");
+      printf("filename : %s\n", pyramidFileName);
+      exit(1);
     }
+    printf("Pyramid Time: %lf.\n", duration_cast<dsec>(Clock::now() - pyramid_start).count());
   }
 
-  for(int counter = 0; counter < num_of_wires; counter++){
-    free(ref_board[counter].board);
-  }
-  free(ref_board);
+  /* FREE TO ALL ! */
 
-  for(int i = 0; i < num_of_wires; i++){
-    free(wires[i].currentPath);
-    free(wires[i].prevPath);
-  }
-  free(wires);
-  free(costs->board);
+  free(corridor);
+  if (trace.file != NULL) trace_close(&trace);
+  if (eco_filename != NULL) eco_free(&eco);
+  if (ooc_dir != NULL) waves_free(&waves);
+  region_free(&pathMem);
+  region_free(&wireMem);
+  freeBoard(costs, &boardMem);
   free(costs);
   return 0;
 }
@@ -7,7 +7,16 @@
 #define __WIREOPT_H__
 
 #include <omp.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "boardmem.h"
+#include "options.h"
 #define WIRE_MAX 20
+/* The board is stored as BOARD_TILE x BOARD_TILE tiles of cells */
+#define BOARD_TILE_SHIFT 4
+#define BOARD_TILE (1 << BOARD_TILE_SHIFT)
+#define BOARD_TILE_CELLS (BOARD_TILE * BOARD_TILE)
 /* value_t struct is used to calculate the local minimum path
  */
 typedef struct{
@@ -36,8 +45,84 @@ typedef struct
 	path_t *prevPath;
 } wire_t;
 
+/* route_memo_t *
+ * A wire's last sweep: starting from 'from' it picked 'to'.  Valid while
+ * the board in the wire's bounding box has not changed since.
+ */
+typedef struct
+{
+  path_t from;
+  path_t to;
+  int valid;
+} route_memo_t;
+
+/* corridor_t *
+ * Bend columns [colLo, colHi) and bend rows [rowLo, rowHi) a sweep may try
+ * (either range may be empty).  Both L routes are always tried.
+ */
+typedef struct
+{
+  int colLo, colHi;
+  int rowLo, rowHi;
+} corridor_t;
+
+/* wave_plan_t *
+ * Wires numbered in ORDER_ROWS order (wireorder.h), cut into runs whose
+ * bounding boxes span at most a budget's worth of board tile rows.  A
+ * dense board keeps its tiles in directory order, so a wave's rows are
+ * one contiguous, sequentially read stretch of its region (outofcore.h).
+ */
+typedef struct
+{
+  int numWaves;
+  int *first;            // wave v is wires [first[v], first[v+1])
+  int *rowLo, *rowHi;    //   and touches tile rows [rowLo[v], rowHi[v]]
+  size_t rowBytes;       // board bytes per tile row
+  size_t budget;         // board bytes a wave may touch
+  const region_t *board; // dense board's region
+} wave_plan_t;
+
+/* route_trace_t *
+ * An open trace of routing decisions (trace.h): one route word per wire
+ * per step, written by a record run and read back by a replay.
+ */
+typedef struct
+{
+  FILE *file;
+  int numWires;
+  int steps;        // steps written so far (record) / in the file (replay)
+  uint32_t *words;  // one step's route words
+  char *swept;      // record: per wire, rerouted by a sweep since the last step
+} route_trace_t;
+
+/* How a sweep over budget picks its bends */
+#define SAMPLE_STRIDED    0 // evenly spaced, from a random offset
+#define SAMPLE_RANDOM     1 // uniformly at random
+#define SAMPLE_CONGESTION 2 // cheapest first by the two fixed segments
+
+/* sweep_ctl_t *
+ * Per call knobs of rerouteWire's sweep, and what it did
+ */
+typedef struct
+{
+  route_memo_t *memo;     // reuse / record the sweep (NULL: neither)
+  const corridor_t *win;  // bends allowed (NULL: all)
+  int budget;             // bend positions to try (0: all)
+  int sampling;           //   SAMPLE_* when there are more than that
+  unsigned int salt;      //   random stream of the sampling
+  long long tried;        // out: candidate routes evaluated
+  long long total;        // out: candidate routes a full sweep evaluates
+  int swept;              // out: the route came from the sweep (else at random)
+} sweep_ctl_t;
+
 /* cost_cell_t *
- * Just an integer, but with a lock for cost array writes per cell
+ * Just an integer, but with a lock for cost array writes per cell.
+ * Readers take no lock (async commits run while other threads evaluate
+ * routes), so val, wire and the list entries are stored and loaded with
+ * relaxed atomics: a reader sees whole values, not a consistent cell.  The
+ * list can lag val by a commit in flight, and decrCell fills the hole it
+ * leaves with the last entry, so a scan at that moment can miss a wire;
+ * cellValue then counts the wire's own crossing and reads one too high.
  */
 typedef struct
 {
@@ -45,11 +130,16 @@ typedef struct
   int list[WIRE_MAX];
 	omp_lock_t lock;
 	int val;
+	int slot;       // wireindex.h number of a congested cell, set by index_layout
 } cost_cell_t;
 
 /* cost_t *
  * the struct defines the board;
  * contains both the previous record and the current board
+ * Cells live in tiles reached through a tilesY x tilesX directory.  A sparse
+ * board starts with every entry on the shared (all zero, read only) 'zero'
+ * tile and gives an entry a tile of its own the first time a cell in it is
+ * written; a dense one allocates them all up front.
  */
 typedef struct
 {
@@ -59,25 +149,121 @@ typedef struct
   int prevAggrTotal;
   int currentMax;
   int currentAggrTotal;
-  cost_cell_t* board;
+  int tilesX;
+  int tilesY;
+  int sparse;
+  size_t usedTiles;    // directory entries off the zero tile
+  cost_cell_t **tiles;
+  cost_cell_t *zero;   // NULL for a dense board
 } cost_t;
 
-/* Command line helper functions */
-const char *get_option_string(const char *option_name, const char *default_value);
-int get_option_int(const char *option_name, int default_value);
-float get_option_float(const char *option_name, float default_value);
+// directory entry of the tile holding cell (x, y)
+static inline size_t tileIndex(const cost_t *costs, int x, int y){
+  return (size_t)(y >> BOARD_TILE_SHIFT) * costs->tilesX + (x >> BOARD_TILE_SHIFT);
+}
+
+// position of cell (x, y) inside its tile
+static inline int tileOffset(int x, int y){
+  return ((y & (BOARD_TILE - 1)) << BOARD_TILE_SHIFT) | (x & (BOARD_TILE - 1));
+}
+
+/* A tile is its BOARD_TILE_CELLS cells followed by two packed planes of
+ * their values: one row major (tileRows), one column major (tileCols).
+ * Every write of a cell's val goes through storeVal so the planes match. */
+#define BOARD_TILE_BYTES (BOARD_TILE_CELLS * (sizeof(cost_cell_t) + 2 * sizeof(int)))
+
+static inline int *tileRows(const cost_cell_t *tile){
+  return (int *)(tile + BOARD_TILE_CELLS);
+}
+
+static inline int *tileCols(const cost_cell_t *tile){
+  return tileRows(tile) + BOARD_TILE_CELLS;
+}
+
+// set cell (x, y), which is c, to val in the cell and both planes
+static inline void storeVal(cost_cell_t *c, int x, int y, int val){
+  const int mask = BOARD_TILE - 1;
+  const cost_cell_t *tile = c - tileOffset(x, y);
+  __atomic_store_n(&c->val, val, __ATOMIC_RELAXED);
+  __atomic_store_n(&tileRows(tile)[tileOffset(x, y)], val, __ATOMIC_RELAXED);
+  __atomic_store_n(&tileCols(tile)[((x & mask) << BOARD_TILE_SHIFT) | (y & mask)], val,
+                   __ATOMIC_RELAXED);
+}
+
+// zero every cell value (and list) of a tile
+static inline void clearTile(cost_cell_t *tile){
+  for (int c = 0; c < BOARD_TILE_CELLS; c++){
+    tile[c].val = 0;
+    tile[c].wire = 0;
+  }
+  memset(tileRows(tile), 0, 2 * BOARD_TILE_CELLS * sizeof(int));
+}
+
+// cell (x, y) for reading: cells of untouched tiles read as zero
+static inline const cost_cell_t *boardCell(const cost_t *costs, int x, int y){
+  return &costs->tiles[tileIndex(costs, x, y)][tileOffset(x, y)];
+}
+
+cost_cell_t *newTile(cost_t *costs, cost_cell_t **entry);
+
+// cell (x, y) for writing: the only place a sparse board grows
+static inline cost_cell_t *writeCell(cost_t *costs, int x, int y){
+  cost_cell_t **entry = &costs->tiles[tileIndex(costs, x, y)];
+  cost_cell_t *tile = __atomic_load_n(entry, __ATOMIC_ACQUIRE);
+  if (tile == costs->zero) tile = newTile(costs, entry);
+  return &tile[tileOffset(x, y)];
+}
+
+/* anneal_opts_t *
+ * How one annealing chain picks and commits its routes
+ */
+typedef struct
+{
+  double SA_prob;
+  int batchSize;    // commit after every batchSize wires (0: all at once)
+  int async;        // commit every wire as soon as it is rerouted
+  int selective;    // reroute only wires through congested cells
+  int threshold;    //   a cell of this cost is congested
+  int slack;        //   and so is any cell within slack of the max
+  int seeded;       // draw from 'seed' (else rand() seeded by the clock)
+  unsigned int seed;
+  int memo;         // reuse a wire's last sweep if nothing near it moved
+  int binned;       // lay out by band owner (seglayout) instead of cell locks
+  const corridor_t *corridor; // per wire bend window (NULL: sweep everything)
+  int budget;       // bend positions a sweep tries per wire (0: all)
+  int sampling;     //   SAMPLE_* used to pick them
+  int fullIter;     //   iteration that sweeps everything regardless
+  const char *focus; // per wire: edited (ECO); reroute only these and their
+                     //   congested neighbours, on a board laid out once (async)
+  const wave_plan_t *waves; // lay out and reroute (Jacobi) wave by wave
+  route_trace_t *trace; // record every iteration's routes (NULL: don't)
+  char *moved;      // per wire: set when a reroute changes its route (NULL: don't)
+  int verbose;      // print per-iteration progress
+} anneal_opts_t;
 
 /* Our helper functions */
-void horizontalCost(cost_cell_t *C, int row, int startX, int endX, int dimY, int wire_n);
-void verticalCost(cost_cell_t *C, int xCoord, int startY, int endY, int dimY, int wire_n);
-void new_rand_path(wire_t *wire);
-void incrCell(cost_cell_t *C, int x, int y, int dimY, int wire_n);
+void horizontalCost(cost_t *costs, int row, int startX, int endX, int wire_n, int delta);
+void verticalCost(cost_t *costs, int xCoord, int startY, int endY, int wire_n, int delta);
+void new_rand_path(wire_t *wire, unsigned int *seed);
+void incrCell(cost_t *costs, int x, int y, int wire_n);
+void decrCell(cost_t *costs, int x, int y, int wire_n);
+void layoutWire(cost_t *costs, const path_t *path, int wire_n, int delta);
+void commitWire(cost_t *costs, wire_t *wire, int wire_n);
+void rerouteWire(cost_t *costs, wire_t *wire, int wire_n, double SA_prob, unsigned int *seed,
+                 sweep_ctl_t *ctl);
+void anneal(cost_t *costs, wire_t *wires, int numWires, const anneal_opts_t *opts,
+            int firstIter, int lastIter);
+int allocBoard(cost_t *costs, region_t *mem, int dimX, int dimY, int huge, int sparse);
+int reserveBoard(cost_t *costs, region_t *mem, int dimX, int dimY, int huge, int sparse);
+void touchBoard(cost_t *costs, region_t *mem, int ty);
+void freeBoard(cost_t *costs, region_t *mem);
+void clearBoard(cost_t *costs);
+void layoutBoard(cost_t *costs, wire_t *wires, int numWires);
 void updateBoard(cost_t* board);
-inline int readBoard(cost_t* board, int x, int y, int wire_n);
-value_t readVertical(cost_t* board, int x, int s_y, int e_y, int wire_n);
-value_t readHorizontal(cost_t* board, int y, int s_x, int e_x, int wire_n);
 value_t calculatePath(cost_t* board, int s_x, int s_y, int e_x, int e_y,
           int numBends, int b1_x, int b1_y, int b2_x, int b2_y, int wire_n);
+void sweepRoutes(cost_t* board, const path_t *path, int wire_n, value_t *best, path_t *next,
+                 sweep_ctl_t *ctl);
 value_t combineValue(value_t v1, value_t v2);
 //void cleanUpWire( cost_t board, path_t * path);
 //inline void decrValue(cost_t board, int x, int y);